@@ -0,0 +1,194 @@
+# Training workload for profile-guided optimization. Invoked by the `pgo-train`
+# target as a script:
+#
+#   cmake -DMINISAT=<minisat> -DMINISAT_SIMP=<minisat-simp>
+#         -DINPUT_DIR=<tests/inputs> -DWORK_DIR=<scratch dir>
+#         [-DPROFILE_DIR=<dir> -DLLVM_PROFDATA=<llvm-profdata>]
+#         -P PgoTrain.cmake
+#
+# The workload is every instance in easy.txt plus a few synthetic instances
+# that stress LEQ propagation and conflict analysis with LEQ reasons, which the
+# SATLIB instances never reach.
+
+foreach (var MINISAT MINISAT_SIMP INPUT_DIR WORK_DIR)
+    if (NOT DEFINED ${var})
+        message(FATAL_ERROR "PgoTrain.cmake: ${var} is not set")
+    endif()
+endforeach()
+
+file(MAKE_DIRECTORY "${WORK_DIR}")
+
+function(pgo_run solver input)
+    execute_process(
+        COMMAND "${solver}" -verb=0 "${input}"
+        RESULT_VARIABLE result
+        OUTPUT_QUIET ERROR_QUIET
+        TIMEOUT 60
+    )
+    # minisat exits with 10/20 for SAT/UNSAT
+    if (NOT result MATCHES "^(10|20)$")
+        message(WARNING "training run failed (${result}): ${solver} ${input}")
+    endif()
+endfunction()
+
+# ---------------------------------------------------------------------------
+# Deterministic instance generators (CMake has no seeded RNG)
+
+set(pgo_rng_state 1)
+
+macro(pgo_rand out bound)
+    math(EXPR pgo_rng_state
+         "(${pgo_rng_state} * 1103515245 + 12345) % 2147483648")
+    math(EXPR ${out} "(${pgo_rng_state} / 65536) % (${bound})")
+endmacro()
+
+# Pigeon-hole principle with n+1 pigeons and n holes where every hole is an
+# at-most-one LEQ; unsatisfiable and conflict-heavy.
+function(pgo_gen_php path n)
+    math(EXPR np1 "${n} + 1")
+    math(EXPR one "${np1} * ${n} + 1")
+    math(EXPR nclauses "${np1} + ${n} + 1")
+    set(text "p cnf ${one} ${nclauses}\n${one} 0\n")
+    foreach (p RANGE 1 ${np1})
+        set(line "")
+        foreach (h RANGE 1 ${n})
+            math(EXPR v "(${p} - 1) * ${n} + ${h}")
+            string(APPEND line "${v} ")
+        endforeach()
+        string(APPEND text "${line}0\n")
+    endforeach()
+    foreach (h RANGE 1 ${n})
+        set(line "")
+        foreach (p RANGE 1 ${np1})
+            math(EXPR v "(${p} - 1) * ${n} + ${h}")
+            string(APPEND line "${v} ")
+        endforeach()
+        string(APPEND text "${line}<= 1 # ${one}\n")
+    endforeach()
+    file(WRITE "${path}" "${text}")
+endfunction()
+
+# Random reified LEQ/GEQ constraints mixed with 3-clauses, all satisfied by a
+# planted assignment; bounds are kept close to the planted count so the
+# constraints propagate often.
+function(pgo_gen_rand path nvar nleq ncls seed)
+    set(pgo_rng_state ${seed})
+    set(assign "")
+    foreach (i RANGE 1 ${nvar})
+        pgo_rand(b 2)
+        list(APPEND assign ${b})
+    endforeach()
+    math(EXPR nclauses "${nleq} + ${ncls}")
+    set(text "p cnf ${nvar} ${nclauses}\n")
+
+    foreach (c RANGE 1 ${nleq})
+        pgo_rand(size 24)
+        math(EXPR size "${size} + 8")
+        set(vars "")
+        set(line "")
+        set(count 0)
+        while (size GREATER 0)
+            pgo_rand(v ${nvar})
+            list(FIND vars ${v} found)
+            if (found EQUAL -1)
+                list(APPEND vars ${v})
+                list(GET assign ${v} val)
+                pgo_rand(neg 2)
+                math(EXPR lit "${v} + 1")
+                if (neg)
+                    set(lit "-${lit}")
+                endif()
+                if (NOT val EQUAL neg)
+                    math(EXPR count "${count} + 1")
+                endif()
+                string(APPEND line "${lit} ")
+                math(EXPR size "${size} - 1")
+            endif()
+        endwhile()
+        pgo_rand(offset 5)
+        math(EXPR bound "${count} + ${offset} - 2")
+        pgo_rand(geq 2)
+        if (geq)
+            set(op ">=")
+            if (count GREATER_EQUAL bound)
+                set(holds 1)
+            else()
+                set(holds 0)
+            endif()
+        else()
+            set(op "<=")
+            if (count LESS_EQUAL bound)
+                set(holds 1)
+            else()
+                set(holds 0)
+            endif()
+        endif()
+        pgo_rand(dst ${nvar})
+        list(GET assign ${dst} val)
+        math(EXPR dst "${dst} + 1")
+        if (NOT val EQUAL holds)
+            set(dst "-${dst}")
+        endif()
+        string(APPEND text "${line}${op} ${bound} # ${dst}\n")
+    endforeach()
+
+    set(c 0)
+    while (c LESS ncls)
+        set(line "")
+        set(sat 0)
+        foreach (k RANGE 1 3)
+            pgo_rand(v ${nvar})
+            list(GET assign ${v} val)
+            pgo_rand(neg 2)
+            math(EXPR lit "${v} + 1")
+            if (neg)
+                set(lit "-${lit}")
+            endif()
+            if (NOT val EQUAL neg)
+                set(sat 1)
+            endif()
+            string(APPEND line "${lit} ")
+        endforeach()
+        if (sat)
+            string(APPEND text "${line}0\n")
+            math(EXPR c "${c} + 1")
+        endif()
+    endwhile()
+    file(WRITE "${path}" "${text}")
+endfunction()
+
+# ---------------------------------------------------------------------------
+# Training runs
+
+file(STRINGS "${INPUT_DIR}/easy.txt" instances)
+list(LENGTH instances nr_instances)
+message(STATUS "PGO training: ${nr_instances} instances from easy.txt")
+foreach (instance ${instances})
+    pgo_run("${MINISAT}" "${INPUT_DIR}/${instance}")
+    if (NOT instance MATCHES "(SAT|UNSAT)/ineq/.*")
+        pgo_run("${MINISAT_SIMP}" "${INPUT_DIR}/${instance}")
+    endif()
+endforeach()
+
+message(STATUS "PGO training: synthetic LEQ instances")
+foreach (n 6 7 8)
+    pgo_gen_php("${WORK_DIR}/php_leq${n}.cnf" ${n})
+    pgo_run("${MINISAT}" "${WORK_DIR}/php_leq${n}.cnf")
+endforeach()
+foreach (seed 1 2 3 4)
+    pgo_gen_rand("${WORK_DIR}/rand_leq${seed}.cnf" 200 250 600 ${seed})
+    pgo_run("${MINISAT}" "${WORK_DIR}/rand_leq${seed}.cnf")
+endforeach()
+
+# Clang writes raw profiles that must be merged before -fprofile-use
+if (LLVM_PROFDATA AND PROFILE_DIR)
+    file(GLOB raw_profiles "${PROFILE_DIR}/*.profraw")
+    execute_process(
+        COMMAND "${LLVM_PROFDATA}" merge
+                -output=${PROFILE_DIR}/default.profdata ${raw_profiles}
+        RESULT_VARIABLE result
+    )
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "llvm-profdata merge failed")
+    endif()
+endif()
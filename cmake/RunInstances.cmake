@@ -0,0 +1,144 @@
+# Runs minisat with extra options on instances from a list file and checks
+# the answers. Invoked by the `option:*` tests as a script:
+#
+#   cmake -DMINISAT=<minisat> -DINPUT_DIR=<tests/inputs> -DLIST=<list file>
+#         [-DOPTIONS="<options>"] [-DFILTER=<regex>] [-DEXCLUDE=<regex>]
+#         [-DREPEAT=<n>]
+#         [-DBATCH_DIR=<scratch dir>] [-DEXPORT_DIR=<scratch dir>]
+#         -P RunInstances.cmake
+#
+# Instances whose path starts with SAT must be satisfiable and the others
+# unsatisfiable. FILTER selects instances by a regular expression on their
+# path, EXCLUDE drops instances matching another one, and REPEAT runs each
+# one several times to catch nondeterministic failures. With BATCH_DIR, all
+# instances are solved by one `-batch` run instead, together with a
+# malformed instance that must fail on its own.
+# With EXPORT_DIR, each instance is written by `-dimacs` with the options
+# after root level simplification, and the written file is solved instead.
+
+foreach (var MINISAT INPUT_DIR LIST)
+    if (NOT DEFINED ${var})
+        message(FATAL_ERROR "RunInstances.cmake: ${var} is not set")
+    endif()
+endforeach()
+if (NOT DEFINED REPEAT)
+    set(REPEAT 1)
+endif()
+separate_arguments(options UNIX_COMMAND "${OPTIONS}")
+
+file(STRINGS "${LIST}" instances)
+if (DEFINED FILTER)
+    list(FILTER instances INCLUDE REGEX "${FILTER}")
+endif()
+if (DEFINED EXCLUDE)
+    list(FILTER instances EXCLUDE REGEX "${EXCLUDE}")
+endif()
+
+function(expected_result instance out)
+    if (instance MATCHES "^SAT")
+        set(${out} SAT PARENT_SCOPE)
+    else()
+        set(${out} UNSAT PARENT_SCOPE)
+    endif()
+endfunction()
+
+if (DEFINED BATCH_DIR)
+    file(REMOVE_RECURSE "${BATCH_DIR}")
+    file(MAKE_DIRECTORY "${BATCH_DIR}")
+    set(bad "${BATCH_DIR}/malformed.cnf")
+    file(WRITE "${bad}" "1 2 x 0\n")
+    set(list_text "${bad}\n")
+    foreach (instance ${instances})
+        string(APPEND list_text "${INPUT_DIR}/${instance}\n")
+    endforeach()
+    file(WRITE "${BATCH_DIR}/list.txt" "${list_text}")
+    execute_process(
+        COMMAND "${MINISAT}" ${options} "-batch=${BATCH_DIR}/list.txt"
+                "-batch-summary=${BATCH_DIR}/summary.txt"
+        RESULT_VARIABLE result
+        OUTPUT_QUIET ERROR_QUIET
+    )
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "batch run failed: ${result}")
+    endif()
+    file(READ "${BATCH_DIR}/summary.txt" summary)
+    set(nr_failed 0)
+    foreach (instance ${instances} malformed)
+        if (instance STREQUAL "malformed")
+            set(path "${bad}")
+            set(expect ERROR)
+        else()
+            set(path "${INPUT_DIR}/${instance}")
+            expected_result("${instance}" expect)
+        endif()
+        string(REGEX REPLACE "([][+.*?()^$|\\])" "\\\\\\1" path "${path}")
+        string(REGEX MATCH "${path} +[A-Z]+ " line "${summary}")
+        if (NOT line MATCHES " ${expect} $")
+            math(EXPR nr_failed "${nr_failed} + 1")
+            message(SEND_ERROR "${instance}: expect ${expect}, got '${line}'")
+        endif()
+    endforeach()
+    list(LENGTH instances nr_run)
+    message(STATUS "batch of ${nr_run} instances, ${nr_failed} failed")
+    return()
+endif()
+
+set(nr_run 0)
+set(nr_failed 0)
+foreach (instance ${instances})
+    # minisat exits with 10/20 for SAT/UNSAT
+    expected_result("${instance}" expect)
+    if (expect STREQUAL "SAT")
+        set(expect 10)
+    else()
+        set(expect 20)
+    endif()
+    set(input "${INPUT_DIR}/${instance}")
+    set(solve_options ${options})
+    if (DEFINED EXPORT_DIR)
+        file(MAKE_DIRECTORY "${EXPORT_DIR}")
+        string(REGEX REPLACE "\\.gz$" "" exported "${instance}")
+        string(REPLACE "/" "_" exported "${exported}")
+        # gzipped and plain output alternate
+        math(EXPR parity "${nr_run} % 2")
+        if (parity)
+            set(exported "${EXPORT_DIR}/${exported}.gz")
+        else()
+            set(exported "${EXPORT_DIR}/${exported}")
+        endif()
+        execute_process(
+            COMMAND "${MINISAT}" -verb=0 ${options} "-dimacs=${exported}"
+                    "${input}"
+            RESULT_VARIABLE result
+            OUTPUT_QUIET ERROR_QUIET
+            TIMEOUT 60
+        )
+        if (NOT result EQUAL 0)
+            math(EXPR nr_failed "${nr_failed} + 1")
+            message(SEND_ERROR "${instance}: export failed: ${result}")
+            continue()
+        endif()
+        set(input "${exported}")
+        set(solve_options "")
+    endif()
+    foreach (i RANGE 1 ${REPEAT})
+        execute_process(
+            COMMAND "${MINISAT}" -verb=0 ${solve_options} "${input}"
+            RESULT_VARIABLE result
+            OUTPUT_QUIET ERROR_QUIET
+            TIMEOUT 60
+        )
+        math(EXPR nr_run "${nr_run} + 1")
+        if (NOT result STREQUAL expect)
+            math(EXPR nr_failed "${nr_failed} + 1")
+            message(SEND_ERROR
+                    "${instance} (run ${i}): expect ${expect}, got ${result}")
+            break()
+        endif()
+    endforeach()
+endforeach()
+
+if (nr_run EQUAL 0)
+    message(FATAL_ERROR "no instance selected")
+endif()
+message(STATUS "${nr_run} runs, ${nr_failed} failed: ${OPTIONS}")
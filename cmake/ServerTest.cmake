@@ -0,0 +1,87 @@
+# End-to-end test of minisat-server and minisat-client. Invoked by the
+# `server` test as a script:
+#
+#   cmake -DSERVER=<minisat-server> -DCLIENT=<minisat-client>
+#         -DINPUT_DIR=<tests/inputs> -DWORK_DIR=<scratch dir>
+#         -P ServerTest.cmake
+#
+# Solves a few instances, checks that oversized jobs are rejected with an
+# error instead of taking the server down, and shuts the server down.
+
+foreach (var SERVER CLIENT INPUT_DIR WORK_DIR)
+    if (NOT DEFINED ${var})
+        message(FATAL_ERROR "ServerTest.cmake: ${var} is not set")
+    endif()
+endforeach()
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+set(socket "${WORK_DIR}/server.sock")
+
+# run the client; set ${out} to its output and ${rc} to its exit code
+function(client out rc)
+    execute_process(
+        COMMAND "${CLIENT}" "-socket=${socket}" ${ARGN}
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE output
+        RESULT_VARIABLE result
+        TIMEOUT 60
+    )
+    set(${out} "${output}" PARENT_SCOPE)
+    set(${rc} "${result}" PARENT_SCOPE)
+endfunction()
+
+function(expect_output name regex)
+    client(output rc ${ARGN})
+    if (NOT output MATCHES "${regex}")
+        message(SEND_ERROR "${name}: expect '${regex}', got:\n${output}")
+    endif()
+endfunction()
+
+# the server runs in the background with its output redirected, so that
+# execute_process() does not wait for it
+execute_process(
+    COMMAND sh -c "exec \"$0\" -socket=\"$1\" -threads=2 -job-mem=64 >\"$2\" 2>&1 &"
+            "${SERVER}" "${socket}" "${WORK_DIR}/server.log"
+    RESULT_VARIABLE result
+)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "could not start ${SERVER}")
+endif()
+
+foreach (i RANGE 100)
+    client(output rc -stats)
+    if (rc EQUAL 0)
+        break()
+    endif()
+    execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 0.1)
+endforeach()
+if (NOT rc EQUAL 0)
+    message(FATAL_ERROR "server did not start:\n${output}")
+endif()
+
+client(output rc "${INPUT_DIR}/SAT/ineq/simple0.cnf")
+if (NOT rc EQUAL 10)
+    message(SEND_ERROR "SAT/ineq/simple0.cnf: expect 10, got ${rc}:\n${output}")
+endif()
+client(output rc "${INPUT_DIR}/UNSAT/ineq/simple1.cnf")
+if (NOT rc EQUAL 20)
+    message(SEND_ERROR "UNSAT/ineq/simple1.cnf: expect 20, got ${rc}:\n${output}")
+endif()
+
+# a short request must not allocate an unbounded number of variables
+file(WRITE "${WORK_DIR}/huge-var.cnf" "1 2 <= 5 # 99999999999\n")
+expect_output(huge-var "error 1 too many variables"
+              "${WORK_DIR}/huge-var.cnf")
+file(WRITE "${WORK_DIR}/huge-base.cnf" "-2000000000 0\n")
+expect_output(huge-base "error huge too many variables"
+              -define-base=huge "${WORK_DIR}/huge-base.cnf")
+expect_output(huge-assume "error 1 too many variables"
+              -assume=2000000000 "${INPUT_DIR}/SAT/ineq/simple0.cnf")
+file(WRITE "${WORK_DIR}/job-mem.cnf" "4000000 0\n")
+expect_output(job-mem "error 1 memory limit exceeded"
+              "${WORK_DIR}/job-mem.cnf")
+
+# the server must still be serving after the rejected jobs
+expect_output(stats "server workers=2 " -stats)
+expect_output(shutdown "ok shutdown" -shutdown)
@@ -0,0 +1,54 @@
+# Runs a short tools/tune.py session twice. Invoked by the `tune` test as a
+# script:
+#
+#   cmake -DPYTHON=<python3> -DTUNE=<tools/tune.py> -DMINISAT=<minisat>
+#         -DLIST=<list file> -DWORK_DIR=<scratch dir> -P TuneTest.cmake
+#
+# The first session must pick a configuration without inconsistent answers,
+# and the second one must take every run from the database of the first.
+
+foreach (var PYTHON TUNE MINISAT LIST WORK_DIR)
+    if (NOT DEFINED ${var})
+        message(FATAL_ERROR "TuneTest.cmake: ${var} is not set")
+    endif()
+endforeach()
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+
+function(tune out)
+    execute_process(
+        COMMAND "${PYTHON}" "${TUNE}" "${MINISAT}" "${LIST}"
+                "--db=${WORK_DIR}/tune.sqlite" --configs=4 --min-instances=4
+                --budget=10 --jobs=2 "--output=${WORK_DIR}/best.txt"
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE output
+        RESULT_VARIABLE result
+        TIMEOUT 300
+    )
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "tune.py failed: ${result}\n${output}")
+    endif()
+    set(${out} "${output}" PARENT_SCOPE)
+endfunction()
+
+tune(output)
+if (output MATCHES "inconsistent" OR NOT output MATCHES "best \\(PAR-2 ")
+    message(SEND_ERROR "unexpected output of the first session:\n${output}")
+endif()
+file(READ "${WORK_DIR}/best.txt" best)
+if (NOT best MATCHES "^-")
+    message(SEND_ERROR "no options written: '${best}'")
+endif()
+
+tune(output)
+string(REGEX MATCHALL "\\([0-9]+ runs," runs "${output}")
+foreach (i ${runs})
+    if (NOT i STREQUAL "(0 runs,")
+        message(SEND_ERROR "resumed session repeated runs:\n${output}")
+        break()
+    endif()
+endforeach()
+if (NOT runs)
+    message(SEND_ERROR "unexpected output of the resumed session:\n${output}")
+endif()
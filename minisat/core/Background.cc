@@ -0,0 +1,466 @@
+/**********************************************************************************[Background.cc]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+
+#include "minisat/core/Solver.h"
+
+#include <algorithm>
+
+using namespace Minisat;
+
+/*
+ * The helper thread loads a snapshot into a private Solver that is only used
+ * for unit propagation. Everything derived from it is implied by the
+ * snapshot, and thus by the current constraints unless some of them have
+ * been removed by pop() since (which discards the result):
+ *  - learnts subsumed by another clause of the snapshot are deleted;
+ *  - failed literals and lits implied by both phases of a var become units;
+ *  - a learnt is shortened to the prefix of its lits whose negation leads to
+ *    a conflict or implies the next lit, dropping lits implied false on the
+ *    way (vivification).
+ * Tainted constraints and root assignments are left out of the snapshot so
+ * that the results are untainted. The solver maps the learnts of the
+ * snapshot to their current CRefs through #bg_simp_learnts.
+ */
+
+/* ===================== BackgroundSimplifier ===================== */
+
+BackgroundSimplifier::~BackgroundSimplifier() {
+    if (m_thread.joinable()) {
+        m_abort = true;
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        m_thread.join();
+    }
+}
+
+bool BackgroundSimplifier::busy() {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_has_job || m_has_result;
+}
+
+void BackgroundSimplifier::submit(Snapshot&& snapshot) {
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        assert(!m_has_job && !m_has_result);
+        m_snapshot = std::move(snapshot);
+        m_has_job = true;
+    }
+    if (!m_thread.joinable()) {
+        m_thread = std::thread{[this]() { thread_main(); }};
+    }
+    m_cv.notify_all();
+}
+
+bool BackgroundSimplifier::poll(Result& result) {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if (!m_has_result) {
+        return false;
+    }
+    result = std::move(m_result);
+    m_result = Result{};
+    m_has_result = false;
+    return true;
+}
+
+void BackgroundSimplifier::thread_main() {
+    std::unique_lock<std::mutex> lock{m_mutex};
+    for (;;) {
+        m_cv.wait(lock, [this]() { return m_stop || m_has_job; });
+        if (m_stop) {
+            return;
+        }
+        Snapshot snapshot = std::move(m_snapshot);
+        m_snapshot = Snapshot{};
+        lock.unlock();
+
+        Result result;
+        run(snapshot, result);
+
+        lock.lock();
+        m_result = std::move(result);
+        m_has_job = false;
+        m_has_result = true;
+    }
+}
+
+void BackgroundSimplifier::run(const Snapshot& snapshot, Result& result) {
+    int64_t ticks = snapshot.ticks;
+    subsume(snapshot, result, ticks);
+
+    Solver engine;
+    engine.verbosity = 0;
+    engine.bg_simp = false;
+    for (int i = 0; i < snapshot.nr_vars; ++i) {
+        engine.newVar();
+    }
+    vec<Lit> ps;
+    for (Lit p : snapshot.units) {
+        engine.addClause(p);
+    }
+    for (int i = 0; i < snapshot.nr_clauses(); ++i) {
+        ps.clear();
+        for (int j = snapshot.begin[i]; j < snapshot.begin[i + 1]; ++j) {
+            ps.push(snapshot.lits[j]);
+        }
+        engine.addClause_(ps);
+    }
+    for (const Snapshot::Leq& leq : snapshot.leqs) {
+        ps.clear();
+        for (int j = 0; j < leq.size; ++j) {
+            ps.push(snapshot.leq_lits[leq.begin + j]);
+        }
+        engine.addLeqAssign_(ps, leq.bound, leq.dst);
+    }
+
+    int nr_fixed = engine.trail.size();
+    if (engine.ok) {
+        probe(engine, snapshot, ticks);
+    }
+    if (engine.ok) {
+        vivify(engine, snapshot, result, ticks);
+    }
+    if (!engine.ok) {
+        result.unsat = true;
+        return;
+    }
+    for (int i = nr_fixed; i < engine.trail.size(); ++i) {
+        result.units.push_back(engine.trail[i]);
+    }
+}
+
+void BackgroundSimplifier::subsume(const Snapshot& snapshot, Result& result,
+                                   int64_t& ticks) {
+    int nr_clauses = snapshot.nr_clauses(), nr_lits = snapshot.nr_vars * 2;
+    auto size_of = [&snapshot](int i) {
+        return snapshot.begin[i + 1] - snapshot.begin[i];
+    };
+
+    // each clause is indexed by its lit with the fewest occurrences, and is
+    // found when a clause containing that lit is checked
+    std::vector<int> nr_occ(nr_lits);
+    for (Lit p : snapshot.lits) {
+        ++nr_occ[toInt(p)];
+    }
+    std::vector<std::vector<int>> index(nr_lits);
+    for (int i = 0; i < nr_clauses; ++i) {
+        Lit best = snapshot.lits[snapshot.begin[i]];
+        for (int j = snapshot.begin[i] + 1; j < snapshot.begin[i + 1]; ++j) {
+            Lit p = snapshot.lits[j];
+            if (nr_occ[toInt(p)] < nr_occ[toInt(best)]) {
+                best = p;
+            }
+        }
+        index[toInt(best)].push_back(i);
+    }
+    ticks -= snapshot.lits.size();
+
+    std::vector<char> mark(nr_lits);
+    for (int i = snapshot.nr_orig; i < nr_clauses && ticks > 0 && !m_abort;
+         ++i) {
+        const Lit* lits = &snapshot.lits[snapshot.begin[i]];
+        int size = size_of(i);
+        for (int k = 0; k < size; ++k) {
+            mark[toInt(lits[k])] = 1;
+        }
+        bool subsumed = false;
+        for (int k = 0; k < size && !subsumed; ++k) {
+            for (int j : index[toInt(lits[k])]) {
+                // of two equal clauses, the later one is deleted
+                int size_j = size_of(j);
+                if (j == i || size_j > size || (size_j == size && j > i)) {
+                    continue;
+                }
+                ticks -= size_j;
+                subsumed = true;
+                for (int t = snapshot.begin[j]; t < snapshot.begin[j + 1];
+                     ++t) {
+                    if (!mark[toInt(snapshot.lits[t])]) {
+                        subsumed = false;
+                        break;
+                    }
+                }
+                if (subsumed) {
+                    break;
+                }
+            }
+        }
+        for (int k = 0; k < size; ++k) {
+            mark[toInt(lits[k])] = 0;
+        }
+        if (subsumed) {
+            result.deleted.push_back(i - snapshot.nr_orig);
+        }
+    }
+}
+
+void BackgroundSimplifier::probe(Solver& engine, const Snapshot& snapshot,
+                                 int64_t& ticks) {
+    Solver& S = engine;
+    int nr_vars = snapshot.nr_vars;
+    if (!nr_vars) {
+        return;
+    }
+    // lits implied by the positive phase of the probed var
+    std::vector<char> implied(nr_vars * 2);
+    vec<Lit> pos_implied, units;
+    int k = 0;
+    for (; k < nr_vars && ticks > 0 && S.ok && !m_abort; ++k) {
+        Var v = (m_probe_next + k) % nr_vars;
+        if (S.value(v) != l_Undef) {
+            continue;
+        }
+        uint64_t props = S.propagations;
+        Lit p = mkLit(v);
+        units.clear();
+        pos_implied.clear();
+
+        S.newDecisionLevel();
+        S.uncheckedEnqueue(p);
+        if (S.propagate() != CRef_Undef) {
+            units.push(~p);
+        } else {
+            for (int i = S.trail_lim[0].lit + 1; i < S.trail.size(); ++i) {
+                pos_implied.push(S.trail[i]);
+                implied[toInt(S.trail[i])] = 1;
+            }
+        }
+        S.cancelUntil(0);
+
+        if (!units.size()) {
+            S.newDecisionLevel();
+            S.uncheckedEnqueue(~p);
+            if (S.propagate() != CRef_Undef) {
+                units.push(p);
+            } else {
+                for (int i = S.trail_lim[0].lit + 1; i < S.trail.size();
+                     ++i) {
+                    if (implied[toInt(S.trail[i])]) {
+                        units.push(S.trail[i]);
+                    }
+                }
+            }
+            S.cancelUntil(0);
+            for (Lit q : pos_implied) {
+                implied[toInt(q)] = 0;
+            }
+        }
+        ticks -= S.propagations - props;
+
+        for (Lit q : units) {
+            if (S.value(q) == l_False) {
+                S.ok = false;
+            } else if (S.value(q) == l_Undef) {
+                S.uncheckedEnqueue(q);
+                S.ok = S.propagate() == CRef_Undef;
+            }
+            if (!S.ok) {
+                break;
+            }
+        }
+    }
+    m_probe_next = (m_probe_next + k) % nr_vars;
+}
+
+void BackgroundSimplifier::vivify(Solver& engine, const Snapshot& snapshot,
+                                  Result& result, int64_t& ticks) {
+    Solver& S = engine;
+    std::vector<char> deleted(snapshot.nr_clauses() - snapshot.nr_orig);
+    for (int i : result.deleted) {
+        deleted[i] = 1;
+    }
+    vec<Lit> kept;
+    // the newest learnts first, as they are used most by the search
+    for (int i = snapshot.nr_clauses() - 1;
+         i >= snapshot.nr_orig && ticks > 0 && !m_abort; --i) {
+        if (deleted[i - snapshot.nr_orig]) {
+            continue;
+        }
+        uint64_t props = S.propagations;
+        int size = snapshot.begin[i + 1] - snapshot.begin[i];
+        const Lit* lits = &snapshot.lits[snapshot.begin[i]];
+        bool satisfied = false;
+        kept.clear();
+        for (int k = 0; k < size; ++k) {
+            Lit p = lits[k];
+            lbool val = S.value(p);
+            if (val == l_True) {
+                // implied by the negation of the kept lits, unless fixed
+                satisfied = S.level(var(p)) == 0;
+                kept.push(p);
+                break;
+            }
+            if (val == l_False) {
+                continue;
+            }
+            kept.push(p);
+            S.newDecisionLevel();
+            S.uncheckedEnqueue(~p);
+            if (S.propagate() != CRef_Undef) {
+                break;
+            }
+        }
+        S.cancelUntil(0);
+        ticks -= S.propagations - props;
+
+        // satisfied learnts are removed by the solver itself
+        if (!satisfied && kept.size() < size) {
+            result.strengthened.emplace_back(
+                    i - snapshot.nr_orig,
+                    std::vector<Lit>(kept.begin(), kept.end()));
+        }
+    }
+}
+
+/* ===================== Solver ===================== */
+
+bool Solver::bg_simp_exchange() {
+    assert(decisionLevel() == 0);
+    BackgroundSimplifier::Result result;
+    if (bg_simplifier.poll(result)) {
+        bool ret = bg_simp_apply(result);
+        bg_simp_learnts.clear();
+        if (!ret) {
+            return false;
+        }
+    }
+    if (conflicts < bg_simp_next_conflicts || bg_simplifier.busy()) {
+        return true;
+    }
+    bg_simp_next_conflicts = conflicts + bg_simp_interval;
+
+    BackgroundSimplifier::Snapshot snapshot;
+    snapshot.nr_vars = nVars();
+    snapshot.ticks = bg_simp_ticks;
+    for (Lit p : trail) {
+        if (!track_taint || !root_taint[var(p)]) {
+            snapshot.units.push_back(p);
+        }
+    }
+    auto add_clause = [&](const Clause& c) {
+        for (int i = 0; i < c.size(); ++i) {
+            snapshot.lits.push_back(c[i]);
+        }
+        snapshot.begin.push_back(snapshot.lits.size());
+    };
+    for (CRef cr : clauses) {
+        const Clause& c = ca[cr];
+        if (track_taint && c.tainted()) {
+            continue;
+        }
+        if (c.is_leq()) {
+            snapshot.leqs.push_back({int(snapshot.leq_lits.size()), c.size(),
+                                     c.leq_bound(), c.leq_dst()});
+            for (int i = 0; i < c.size(); ++i) {
+                snapshot.leq_lits.push_back(c[i]);
+            }
+        } else {
+            add_clause(c);
+        }
+    }
+    snapshot.nr_orig = snapshot.nr_clauses();
+    bg_simp_learnts.clear();
+    for (CRef cr : learnts) {
+        const Clause& c = ca[cr];
+        if (!track_taint || !c.tainted()) {
+            add_clause(c);
+            bg_simp_learnts.push(cr);
+        }
+    }
+    bg_simp_snapshot_epoch = bg_simp_epoch;
+    bg_simplifier.submit(std::move(snapshot));
+    return true;
+}
+
+bool Solver::bg_simp_apply(BackgroundSimplifier::Result& result) {
+    if (bg_simp_snapshot_epoch != bg_simp_epoch) {
+        // constraints have been removed since the snapshot
+        return true;
+    }
+    ++bg_simp_rounds;
+    if (result.unsat) {
+        return ok = false;
+    }
+
+    // vars that are no longer decision vars have been eliminated,
+    // substituted or removed; they should not come back into the clauses
+    vec<Lit> ps;
+    for (Lit p : result.units) {
+        if (decision[var(p)] && value(p) != l_True) {
+            ps.clear();
+            ps.push(p);
+            if (!import_learnt(ps)) {
+                return false;
+            }
+            ++bg_simp_units;
+        }
+    }
+
+    auto alive = [this](CRef cr) {
+        return cr != CRef_Undef && ca[cr].mark() != 1;
+    };
+    bool removed = false;
+    for (int i : result.deleted) {
+        if (CRef cr = bg_simp_learnts[i]; alive(cr)) {
+            removeClause(cr);
+            ++bg_simp_deleted;
+            removed = true;
+        }
+    }
+    for (auto& [i, lits] : result.strengthened) {
+        CRef cr = bg_simp_learnts[i];
+        bool usable = alive(cr);
+        ps.clear();
+        for (Lit p : lits) {
+            usable &= decision[var(p)];
+            ps.push(p);
+        }
+        if (!usable) {
+            continue;
+        }
+        float act = ca[cr].activity();
+        int nr_learnts = learnts.size();
+        if (!import_learnt(ps, ca[cr].tainted())) {
+            return false;
+        }
+        if (learnts.size() > nr_learnts) {
+            ca[learnts.last()].activity() = act;
+        }
+        removeClause(cr);
+        ++bg_simp_strengthened;
+        removed = true;
+    }
+
+    if (removed) {
+        int i, j;
+        for (i = j = 0; i < learnts.size(); i++) {
+            if (ca[learnts[i]].mark() != 1) {
+                learnts[j++] = learnts[i];
+            }
+        }
+        learnts.shrink(i - j);
+        checkGarbage();
+    }
+    return true;
+}
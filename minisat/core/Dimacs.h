@@ -54,20 +54,13 @@ static bool readClause(B& in, Solver& S, vec<Lit>& lits) {
             char op = *in;
             ++in;
             if (*in != '=') {
-                fprintf(stderr,
-                        "PARSE ERROR! Unexpected char in inequality: %c\n",
-                        *in),
-                        exit(3);
+                parseError("Unexpected char in inequality", *in);
             }
             ++in;
             int bound = parseInt(in);
             skipWhitespace(in);
             if (*in != '#') {
-                fprintf(stderr,
-                        "PARSE ERROR! Unexpected char in inequality assign: "
-                        "%c\n",
-                        *in),
-                        exit(3);
+                parseError("Unexpected char in inequality assign", *in);
             }
             ++in;
             Lit dst = get_lit(parseInt(in));
@@ -90,8 +83,10 @@ static bool readClause(B& in, Solver& S, vec<Lit>& lits) {
 template <class B, class Solver>
 static void parse_DIMACS_main(B& in, Solver& S) {
     vec<Lit> lits;
-    int vars = 0;
-    int clauses = 0;
+    // header counts are only checked if there is a header; it is optional for
+    // incremental input such as the deltas sent to minisat-server
+    int vars = -1;
+    int clauses = -1;
     int cnt = 0;
     size_t cmdlen;
     char cmd[6];
@@ -99,12 +94,12 @@ static void parse_DIMACS_main(B& in, Solver& S) {
         skipWhitespace(in);
         switch (*in) {
             case EOF:
-                if (vars != S.nVars()) {
+                if (vars >= 0 && vars != S.nVars()) {
                     fprintf(stderr,
                             "WARNING! DIMACS header mismatch: wrong number of "
                             "variables.\n");
                 }
-                if (cnt != clauses) {
+                if (clauses >= 0 && cnt != clauses) {
                     fprintf(stderr,
                             "WARNING! DIMACS header mismatch: wrong number of "
                             "clauses.\n");
@@ -118,8 +113,7 @@ static void parse_DIMACS_main(B& in, Solver& S) {
                     // if (clauses > 4000000)
                     //     S.eliminate(true);
                 } else {
-                    fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", *in);
-                    exit(3);
+                    parseError("Unexpected char", *in);
                 }
                 break;
             case 'c':
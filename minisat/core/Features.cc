@@ -0,0 +1,180 @@
+/************************************************************************************[Features.cc]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "minisat/core/Features.h"
+#include "minisat/core/Solver.h"
+#include "minisat/utils/System.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+using namespace Minisat;
+
+int InstanceFeatures::size_bucket(int size) {
+    if (size <= 4) {
+        return std::max(size, 1) - 1;
+    }
+    int ret = 4;
+    for (int limit = 8; size > limit && ret < NR_BUCKET - 1; limit *= 2) {
+        ++ret;
+    }
+    return ret;
+}
+
+void InstanceFeatures::print() const {
+    auto row = [](const char* name, const int* hist) {
+        char buf[128];
+        int len = snprintf(buf, sizeof(buf), "%-14s", name);
+        for (int i = 0; i < NR_BUCKET; ++i) {
+            len += snprintf(buf + len, sizeof(buf) - len, " %6d", hist[i]);
+        }
+        printf("|  %-74s |\n", buf);
+    };
+    printf("============================[ Instance Features ]"
+           "==============================\n");
+    printf("|  %-74s |\n",
+           "Size buckets:       1      2      3      4    5-8   9-16  17-32"
+           "    33+");
+    row("  clauses", clause_size);
+    row("  LEQs", leq_size);
+    row("LEQ bound/size", leq_bound);
+    printf("|  Binary clauses: %6.3f    LEQ literals: %6.3f    Size uniformity: "
+           "%6.3f |\n",
+           binary_ratio, leq_lit_ratio, size_uniformity);
+    printf("|  Var degree: mean %8.2f  cv %6.2f  max %9d    LEQ overlap: %6.3f "
+           "|\n",
+           degree_mean, degree_cv, degree_max, leq_overlap);
+    printf("|  Extraction time:      %12.4f s                                  "
+           "     |\n",
+           time);
+}
+
+SolverProfile Minisat::select_profile(const InstanceFeatures& f) {
+    if (f.nr_leqs && f.leq_lit_ratio >= 0.2) {
+        return SolverProfile::LEQ;
+    }
+    if (!f.nr_leqs && f.size_uniformity >= 0.9 && f.binary_ratio < 0.1 &&
+        f.degree_cv < 0.5) {
+        return SolverProfile::RANDOM;
+    }
+    return SolverProfile::DEFAULT;
+}
+
+static const char* const PROFILE_NAMES[] = {"default", "random", "leq"};
+
+const char* Minisat::profile_name(SolverProfile profile) {
+    return PROFILE_NAMES[static_cast<int>(profile)];
+}
+
+bool Minisat::parse_profile(const char* name, SolverProfile& profile) {
+    for (int i = 0; i < 3; ++i) {
+        if (!strcmp(name, PROFILE_NAMES[i])) {
+            profile = static_cast<SolverProfile>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+InstanceFeatures Solver::extract_features() const {
+    double start = cpuTime();
+    InstanceFeatures ret;
+    ret.nr_vars = nVars();
+
+    // number of constraints / LEQs each variable occurs in
+    std::vector<int> degree(nVars()), leq_degree(nVars());
+    int nr_binary = 0;
+    for (CRef cr : clauses) {
+        const Clause& c = ca[cr];
+        int bucket = InstanceFeatures::size_bucket(c.size());
+        for (int i = 0; i < c.size(); ++i) {
+            ++degree[var(c[i])];
+        }
+        if (c.is_leq()) {
+            ++ret.nr_leqs;
+            ret.nr_leq_lits += c.size();
+            ++ret.leq_size[bucket];
+            double ratio = std::min(std::max(double(c.leq_bound()) / c.size(),
+                                             0.0), 1.0);
+            ++ret.leq_bound[std::min<int>(ratio * InstanceFeatures::NR_BUCKET,
+                                          InstanceFeatures::NR_BUCKET - 1)];
+            ++degree[var(c.leq_dst())];
+            for (int i = 0; i < c.size(); ++i) {
+                ++leq_degree[var(c[i])];
+            }
+        } else {
+            ++ret.nr_clauses;
+            ret.nr_clause_lits += c.size();
+            ++ret.clause_size[bucket];
+            nr_binary += c.size() == 2;
+        }
+    }
+
+    if (ret.nr_clauses) {
+        ret.binary_ratio = double(nr_binary) / ret.nr_clauses;
+        ret.size_uniformity =
+                double(*std::max_element(ret.clause_size,
+                                         ret.clause_size +
+                                                 InstanceFeatures::NR_BUCKET)) /
+                ret.nr_clauses;
+    }
+    if (ret.nr_clause_lits + ret.nr_leq_lits) {
+        ret.leq_lit_ratio = double(ret.nr_leq_lits) /
+                            (ret.nr_clause_lits + ret.nr_leq_lits);
+    }
+
+    int nr_used = 0;
+    double sum = 0, sum_sqr = 0;
+    for (int d : degree) {
+        if (d) {
+            ++nr_used;
+            sum += d;
+            sum_sqr += double(d) * d;
+            ret.degree_max = std::max(ret.degree_max, d);
+        }
+    }
+    if (nr_used) {
+        ret.degree_mean = sum / nr_used;
+        double variance = std::max(
+                sum_sqr / nr_used - ret.degree_mean * ret.degree_mean, 0.0);
+        ret.degree_cv = std::sqrt(variance) / ret.degree_mean;
+    }
+
+    if (ret.nr_leqs) {
+        double overlap = 0;
+        for (CRef cr : clauses) {
+            const Clause& c = ca[cr];
+            if (c.is_leq()) {
+                int shared = 0;
+                for (int i = 0; i < c.size(); ++i) {
+                    shared += leq_degree[var(c[i])] > 1;
+                }
+                overlap += double(shared) / c.size();
+            }
+        }
+        ret.leq_overlap = overlap / ret.nr_leqs;
+    }
+
+    ret.time = cpuTime() - start;
+    return ret;
+}
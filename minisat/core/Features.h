@@ -0,0 +1,85 @@
+/*************************************************************************************[Features.h]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+namespace Minisat {
+
+//! structural statistics of a problem, collected by
+//! Solver::extract_features() in one linear pass over the constraints
+struct InstanceFeatures {
+    //! number of buckets in the histograms below
+    static constexpr int NR_BUCKET = 8;
+
+    int nr_vars = 0, nr_clauses = 0, nr_leqs = 0;
+    int64_t nr_clause_lits = 0, nr_leq_lits = 0;
+
+    //! clause sizes in buckets 1, 2, 3, 4, 5-8, 9-16, 17-32, 33+; see
+    //! size_bucket()
+    int clause_size[NR_BUCKET] = {};
+    //! LEQ sizes, in the same buckets as clause_size
+    int leq_size[NR_BUCKET] = {};
+    //! bound / size of LEQs in equal-width buckets over [0, 1]
+    int leq_bound[NR_BUCKET] = {};
+
+    //! fraction of clauses that are binary
+    double binary_ratio = 0;
+    //! fraction of literal occurrences that are in LEQs
+    double leq_lit_ratio = 0;
+    //! fraction of clauses in the most common clause size bucket
+    double size_uniformity = 0;
+
+    //! number of constraints a variable occurs in (LEQ dst included), over
+    //! variables that occur at all
+    double degree_mean = 0, degree_cv = 0;
+    int degree_max = 0;
+
+    //! average fraction of the variables of a LEQ that also occur in another
+    //! LEQ
+    double leq_overlap = 0;
+
+    //! CPU seconds spent on extraction
+    double time = 0;
+
+    static int size_bucket(int size);
+
+    //! print the features as rows of the verbose statistics table
+    void print() const;
+};
+
+//! parameter sets chosen by select_profile()
+enum class SolverProfile {
+    DEFAULT,  //!< keep the option values
+    RANDOM,   //!< uniform random CNF
+    LEQ,      //!< dominated by cardinality constraints
+};
+
+//! rule-based choice of the profile that suits an instance
+SolverProfile select_profile(const InstanceFeatures& features);
+
+const char* profile_name(SolverProfile profile);
+
+//! parse a name returned by profile_name(); return false if unknown
+bool parse_profile(const char* name, SolverProfile& profile);
+
+}  // namespace Minisat
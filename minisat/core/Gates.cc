@@ -0,0 +1,245 @@
+/***************************************************************************************[Gates.cc]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "minisat/core/Gates.h"
+#include "minisat/core/Solver.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace Minisat;
+
+namespace {
+//! max size of clauses checked for AND gates
+constexpr int MAX_AND_SIZE = 64;
+//! bits per lit in the keys of ternary clauses
+constexpr int KEY_BITS = 21;
+
+uint64_t binary_key(Lit a, Lit b) {
+    uint64_t x = toInt(a), y = toInt(b);
+    if (x > y) {
+        std::swap(x, y);
+    }
+    return (x << 32) | y;
+}
+
+uint64_t ternary_key(Lit a, Lit b, Lit c) {
+    uint64_t x[3] = {uint64_t(toInt(a)), uint64_t(toInt(b)),
+                     uint64_t(toInt(c))};
+    std::sort(x, x + 3);
+    return (x[0] << (2 * KEY_BITS)) | (x[1] << KEY_BITS) | x[2];
+}
+
+//! gates in the order they are found, before the cyclic ones are removed
+struct GateBuilder {
+    GateNetwork& net;
+    const vec<CRef>& clauses;
+    //! whether a clause (by index in clauses) encodes a gate
+    std::vector<char> claimed;
+
+    void add(Lit out, const Lit* lits, int size, int bound, bool is_xor,
+             const int* idx, int nr_idx) {
+        net.gate_of[var(out)] = net.gates.size();
+        net.gates.push_back({out, int(net.lits.size()), size, bound, is_xor,
+                             int(net.crefs.size()), nr_idx});
+        net.lits.insert(net.lits.end(), lits, lits + size);
+        for (int i = 0; i < nr_idx; ++i) {
+            claimed[idx[i]] = 1;
+            net.crefs.push_back(clauses[idx[i]]);
+        }
+    }
+};
+}  // anonymous namespace
+
+void Solver::extract_gates(GateNetwork& net) const {
+    net = GateNetwork{};
+    net.gate_of.assign(nVars(), -1);
+    GateBuilder builder{net, clauses, std::vector<char>(clauses.size(), 0)};
+    auto is_free = [&](Lit p) {
+        return net.gate_of[var(p)] == -1 && rootValue(p) == l_Undef;
+    };
+
+    std::vector<int> idx;
+    std::vector<Lit> lits;
+    for (int i = 0; i < clauses.size(); ++i) {
+        const Clause& c = ca[clauses[i]];
+        if (c.is_leq() && is_free(c.leq_dst())) {
+            lits.clear();
+            for (int j = 0; j < c.size(); ++j) {
+                lits.push_back(c[j]);
+            }
+            builder.add(c.leq_dst(), lits.data(), c.size(), c.leq_bound(),
+                        false, &i, 1);
+        }
+    }
+
+    std::unordered_map<uint64_t, int> binary, ternary;
+    for (int i = 0; i < clauses.size(); ++i) {
+        const Clause& c = ca[clauses[i]];
+        if (c.is_leq()) {
+            continue;
+        }
+        if (c.size() == 2) {
+            binary.emplace(binary_key(c[0], c[1]), i);
+        } else if (c.size() == 3 && 2 * int64_t(nVars()) < (1 << KEY_BITS)) {
+            ternary.emplace(ternary_key(c[0], c[1], c[2]), i);
+        }
+    }
+
+    // out = AND(a_1, ..., a_k) is encoded as (out | ~a_1 | ... | ~a_k) and
+    // (~out | a_i); it is the LEQ out <=> (sum(~a_i) <= 0)
+    for (int i = 0; i < clauses.size() && !binary.empty(); ++i) {
+        const Clause& c = ca[clauses[i]];
+        if (c.is_leq() || c.size() > MAX_AND_SIZE || builder.claimed[i]) {
+            continue;
+        }
+        for (int j = 0; j < c.size(); ++j) {
+            Lit out = c[j];
+            if (!is_free(out)) {
+                continue;
+            }
+            idx.assign(1, i);
+            lits.clear();
+            for (int k = 0; k < c.size() && idx.size(); ++k) {
+                if (k == j) {
+                    continue;
+                }
+                auto it = binary.find(binary_key(~out, ~c[k]));
+                if (it == binary.end() || builder.claimed[it->second]) {
+                    idx.clear();
+                } else {
+                    idx.push_back(it->second);
+                    lits.push_back(c[k]);
+                }
+            }
+            if (!idx.empty()) {
+                builder.add(out, lits.data(), lits.size(), 0, false,
+                            idx.data(), idx.size());
+                ++net.nr_and;
+                break;
+            }
+        }
+    }
+
+    // a ternary XOR is encoded by the four clauses over its vars whose
+    // numbers of negative lits have the same parity
+    for (int i = 0; i < clauses.size() && !ternary.empty(); ++i) {
+        const Clause& c = ca[clauses[i]];
+        if (c.is_leq() || c.size() != 3 || builder.claimed[i] ||
+            var(c[0]) == var(c[1]) || var(c[0]) == var(c[2]) ||
+            var(c[1]) == var(c[2])) {
+            continue;
+        }
+        idx.assign(1, i);
+        for (uint64_t key : {ternary_key(~c[0], ~c[1], c[2]),
+                             ternary_key(~c[0], c[1], ~c[2]),
+                             ternary_key(c[0], ~c[1], ~c[2])}) {
+            auto it = ternary.find(key);
+            if (it == ternary.end() || builder.claimed[it->second]) {
+                break;
+            }
+            idx.push_back(it->second);
+        }
+        if (idx.size() != 4) {
+            continue;
+        }
+        // the vars satisfy v0 ^ v1 ^ v2 = !parity; the last var that is not
+        // defined yet is taken as the output
+        int out = -1;
+        bool parity = false;
+        for (int j = 0; j < 3; ++j) {
+            parity ^= sign(c[j]);
+            if (is_free(c[j])) {
+                out = j;
+            }
+        }
+        if (out == -1) {
+            continue;
+        }
+        lits.clear();
+        for (int j = 0; j < 3; ++j) {
+            if (j != out) {
+                lits.push_back(mkLit(var(c[j])));
+            }
+        }
+        builder.add(mkLit(var(c[out]), !parity), lits.data(), 2, 0, true,
+                    idx.data(), 4);
+        ++net.nr_xor;
+    }
+
+    // topological order by iterative DFS; a gate reached again while it is
+    // on the stack closes a cycle and is turned into an input
+    constexpr char NEW = 0, ACTIVE = 1, DONE = 2;
+    std::vector<char> state(nVars(), NEW);
+    std::vector<std::pair<Var, int>> stack;
+    std::vector<int> order;
+    for (Var root = 0; root < nVars(); ++root) {
+        if (net.gate_of[root] == -1 || state[root] != NEW) {
+            continue;
+        }
+        state[root] = ACTIVE;
+        stack.push_back({root, 0});
+        while (!stack.empty()) {
+            auto& [v, next] = stack.back();
+            int g = net.gate_of[v];
+            if (g != -1 && next < net.gates[g].size) {
+                Var u = var(net.lits[net.gates[g].lits_begin + next]);
+                ++next;
+                if (net.gate_of[u] == -1) {
+                    continue;
+                }
+                if (state[u] == ACTIVE) {
+                    net.gate_of[u] = -1;
+                } else if (state[u] == NEW) {
+                    state[u] = ACTIVE;
+                    stack.push_back({u, 0});
+                }
+                continue;
+            }
+            state[v] = DONE;
+            if (g != -1) {
+                order.push_back(g);
+            }
+            stack.pop_back();
+        }
+    }
+
+    // the constraints of the gates turned into inputs are dropped as well
+    std::vector<GateNetwork::Gate> gates;
+    std::vector<CRef> crefs;
+    gates.reserve(order.size());
+    net.nr_and = net.nr_xor = 0;
+    for (int g : order) {
+        GateNetwork::Gate gate = net.gates[g];
+        const CRef* gate_crefs = net.gate_crefs(gate);
+        if (gate.is_xor) {
+            ++net.nr_xor;
+        } else if (!ca[gate_crefs[0]].is_leq()) {
+            ++net.nr_and;
+        }
+        net.gate_of[var(gate.out)] = gates.size();
+        gate.crefs_begin = crefs.size();
+        crefs.insert(crefs.end(), gate_crefs, gate_crefs + gate.nr_crefs);
+        gates.push_back(gate);
+    }
+    net.gates.swap(gates);
+    net.crefs.swap(crefs);
+}
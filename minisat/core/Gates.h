@@ -0,0 +1,74 @@
+/****************************************************************************************[Gates.h]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#pragma once
+
+#include "minisat/core/SolverTypes.h"
+
+#include <vector>
+
+namespace Minisat {
+
+//! vars that are functions of other vars, found by Solver::extract_gates():
+//! the dst of an LEQ, and AND / XOR gates encoded by clauses. The gates are
+//! acyclic and each constraint encodes at most one gate, so the constraints
+//! of a gate whose output is not used elsewhere can be dropped and the
+//! output recomputed from its inputs.
+struct GateNetwork {
+    //! out <=> (sum(lits) <= bound), or out <=> XOR(lits) if is_xor is set
+    struct Gate {
+        Lit out;
+        int lits_begin, size, bound;
+        bool is_xor;
+        //! the constraints that encode the gate
+        int crefs_begin, nr_crefs;
+    };
+
+    //! gates in topological order
+    std::vector<Gate> gates;
+    std::vector<Lit> lits;
+    //! the constraints that encode the gates; those of the gates dropped to
+    //! break a cycle are not listed
+    std::vector<CRef> crefs;
+    //! index of the gate defining each var, or -1 for inputs
+    std::vector<int> gate_of;
+    int nr_and = 0, nr_xor = 0;
+
+    const Lit* gate_lits(const Gate& g) const { return &lits[g.lits_begin]; }
+    const CRef* gate_crefs(const Gate& g) const {
+        return &crefs[g.crefs_begin];
+    }
+
+    //! value of the output var of @p g given the values of its inputs in
+    //! @p values
+    template <class Values>
+    bool eval(const Gate& g, const Values& values) const {
+        const Lit* p = gate_lits(g);
+        int cnt = 0;
+        for (int i = 0; i < g.size; ++i) {
+            cnt += (values[var(p[i])] == l_True) ^ sign(p[i]);
+        }
+        bool ret = g.is_xor ? cnt & 1 : cnt <= g.bound;
+        return ret ^ sign(g.out);
+    }
+};
+
+}  // namespace Minisat
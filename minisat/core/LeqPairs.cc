@@ -0,0 +1,205 @@
+/************************************************************************************[LeqPairs.cc]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "minisat/core/Solver.h"
+
+#include <algorithm>
+
+using namespace Minisat;
+
+/*
+ * Two LEQs dst_a <=> (sum(A) <= k_a) and dst_b <=> (sum(B) <= k_b) over
+ * overlapping lits are split into the lits S that occur in both, the lits C
+ * that occur in A and negated in B, and the lits only in A or only in B.
+ * With s true lits in S and c true lits of C in A, sum(A) ranges over
+ * [s + c, s + c + |A - S - C|] and sum(B) over [s + |C| - c, s + |C| - c +
+ * |B - S - C|]. For each of the four assignments of (dst_a, dst_b), the
+ * bounds on s are checked for every c; an assignment that admits none is
+ * excluded by a binary learnt clause, or by a unit if both assignments of
+ * one dst are excluded. Neurons of the same layer share their inputs, so
+ * these relations are found here instead of by search.
+ */
+
+namespace {
+//! an LEQ restricted to the lits without a root value
+struct LeqInfo {
+    CRef cr;
+    Lit dst;
+    int size, bound;
+};
+
+//! whether sum(A) <= k_a is @p a and sum(B) <= k_b is @p b for some
+//! assignment of the lits
+bool leq_pair_feasible(const LeqInfo& x, const LeqInfo& y, int nr_same,
+                       int nr_comp, bool a, bool b) {
+    int only_x = x.size - nr_same - nr_comp,
+        only_y = y.size - nr_same - nr_comp;
+    for (int c = 0; c <= nr_comp; ++c) {
+        int lo = 0, hi = nr_same;
+        if (a) {
+            hi = std::min(hi, x.bound - c);
+        } else {
+            lo = std::max(lo, x.bound + 1 - only_x - c);
+        }
+        if (b) {
+            hi = std::min(hi, y.bound - nr_comp + c);
+        } else {
+            lo = std::max(lo, y.bound + 1 - nr_comp - only_y + c);
+        }
+        if (lo <= hi) {
+            return true;
+        }
+    }
+    return false;
+}
+}  // anonymous namespace
+
+bool Solver::derive_leq_pairs() {
+    assert(decisionLevel() == 0);
+    std::vector<LeqInfo> leqs;
+    // (LEQ, sign) of the occurrences of each var in the LEQs
+    std::vector<std::vector<std::pair<int, bool>>> occ(nVars());
+    // whether a var occurs in a constraint other than as an LEQ dst
+    std::vector<char> used(nVars(), 0);
+    for (CRef cr : clauses) {
+        const Clause& c = ca[cr];
+        int size = 0, bound = c.is_leq() ? c.leq_bound() : 0;
+        for (int i = 0; i < c.size(); ++i) {
+            used[var(c[i])] = 1;
+            lbool v = rootValue(c[i]);
+            size += v == l_Undef;
+            bound -= v == l_True;
+        }
+        // LEQs whose dst is implied are left to propagation
+        if (!c.is_leq() || rootValue(c.leq_dst()) != l_Undef || bound < 0 ||
+            bound >= size) {
+            continue;
+        }
+        int id = leqs.size();
+        leqs.push_back({cr, c.leq_dst(), size, bound});
+        for (int i = 0; i < c.size(); ++i) {
+            if (rootValue(c[i]) == l_Undef) {
+                occ[var(c[i])].push_back({id, sign(c[i])});
+            }
+        }
+    }
+    for (const XorConstraint& x : xors) {
+        for (Var v : x.vars) {
+            used[v] = 1;
+        }
+    }
+
+    // a relation on a dst that nothing else uses is useless, and would keep
+    // the dst from being removed as a dead var
+    auto is_used = [&](Lit dst) { return incremental || used[var(dst)]; };
+
+    std::vector<int> nr_same(leqs.size(), 0), nr_comp(leqs.size(), 0);
+    std::vector<int> touched;
+    std::vector<std::pair<vec<Lit>, bool>> derived;
+    int64_t ticks = 0;
+    for (int i = 0; i < int(leqs.size()) && ticks < leq_pair_ticks; ++i) {
+        const LeqInfo& x = leqs[i];
+        if (!is_used(x.dst)) {
+            continue;
+        }
+        const Clause& c = ca[x.cr];
+        for (int k = 0; k < c.size(); ++k) {
+            if (rootValue(c[k]) != l_Undef) {
+                continue;
+            }
+            const auto& vo = occ[var(c[k])];
+            // occurrence lists are sorted by LEQ, so only later ones are
+            // visited to check each pair once
+            auto it = std::upper_bound(vo.begin(), vo.end(),
+                                       std::make_pair(i, true));
+            ticks += vo.end() - it + 1;
+            for (; it != vo.end(); ++it) {
+                int j = it->first;
+                if (!nr_same[j] && !nr_comp[j]) {
+                    touched.push_back(j);
+                }
+                if (it->second == sign(c[k])) {
+                    ++nr_same[j];
+                } else {
+                    ++nr_comp[j];
+                }
+            }
+        }
+        for (int j : touched) {
+            const LeqInfo& y = leqs[j];
+            int same = nr_same[j], comp = nr_comp[j];
+            nr_same[j] = nr_comp[j] = 0;
+            // only pairs that share at least half of the smaller LEQ
+            if (2 * (same + comp) < std::min(x.size, y.size) ||
+                var(x.dst) == var(y.dst) || !is_used(y.dst)) {
+                continue;
+            }
+            ticks += 4 * (comp + 1);
+            bool excluded[2][2];
+            for (int a = 0; a < 2; ++a) {
+                for (int b = 0; b < 2; ++b) {
+                    excluded[a][b] =
+                            !leq_pair_feasible(x, y, same, comp, a, b);
+                }
+            }
+            bool taint = ca[x.cr].tainted() || ca[y.cr].tainted();
+            auto add = [&](std::initializer_list<Lit> lits) {
+                derived.emplace_back();
+                for (Lit p : lits) {
+                    derived.back().first.push(p);
+                }
+                derived.back().second = taint;
+            };
+            // the lit of a dst that is true when it takes value v
+            auto lx = [&](int v) { return v ? x.dst : ~x.dst; };
+            auto ly = [&](int v) { return v ? y.dst : ~y.dst; };
+            for (int v = 0; v < 2; ++v) {
+                if (excluded[v][0] && excluded[v][1]) {
+                    add({~lx(v)});
+                }
+                if (excluded[0][v] && excluded[1][v]) {
+                    add({~ly(v)});
+                }
+            }
+            for (int a = 0; a < 2; ++a) {
+                for (int b = 0; b < 2; ++b) {
+                    if (excluded[a][b] && !excluded[a][!b] &&
+                        !excluded[!a][b]) {
+                        add({~lx(a), ~ly(b)});
+                    }
+                }
+            }
+        }
+        touched.clear();
+    }
+
+    for (auto& [ps, taint] : derived) {
+        if (ps.size() == 1) {
+            ++leq_pair_units;
+        } else {
+            ++leq_pair_binaries;
+        }
+        if (!import_learnt(ps, taint)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -20,9 +20,23 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include <errno.h>
 
+#include <pthread.h>
 #include <signal.h>
+#include <time.h>
 #include <zlib.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "minisat/mtl/XAlloc.h"
 #include "minisat/utils/System.h"
 #include "minisat/utils/ParseUtils.h"
 #include "minisat/utils/Options.h"
@@ -63,6 +77,191 @@ static void SIGINT_exit(int) {
     _exit(1); }
 
 
+//=================================================================================================
+// Batch mode: solve many instances concurrently within one process.
+
+
+struct BatchJob {
+    std::string path;
+    const char* result   = "-";
+    double      wall     = 0;
+    double      cpu      = 0;
+    uint64_t    conflicts = 0;
+    double      mem      = 0;       // Solver::mem_footprint() at the end, in MB.
+};
+
+struct BatchWorker {
+    std::mutex  mtx;                // Protects the fields below, which are read by the monitor.
+    Solver*     solver   = nullptr;
+    clockid_t   cpu_clock;
+    double      cpu_start;          // Thread CPU time when the current job started.
+    std::chrono::steady_clock::time_point start;
+};
+
+static double threadCpuTime(clockid_t clock) {
+    timespec ts;
+    if (clock_gettime(clock, &ts) != 0) return 0;
+    return ts.tv_sec + ts.tv_nsec * 1e-9; }
+
+// Collect instances from a directory (all regular files, sorted) or a file with one path per line.
+static bool collectBatch(const char* source, std::vector<BatchJob>& jobs)
+{
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if (fs::is_directory(source, ec)){
+        std::vector<std::string> paths;
+        for (auto& e : fs::recursive_directory_iterator(source, ec))
+            if (e.is_regular_file()) paths.push_back(e.path().string());
+        if (ec) return false;
+        std::sort(paths.begin(), paths.end());
+        for (auto& p : paths) jobs.emplace_back(), jobs.back().path = p;
+        return true; }
+
+    std::ifstream list(source);
+    if (!list) return false;
+    std::string line;
+    while (std::getline(list, line)){
+        line.erase(0, line.find_first_not_of(" \t\r"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (!line.empty() && line[0] != '#')
+            jobs.emplace_back(), jobs.back().path = line; }
+    return true;
+}
+
+static void writeResult(FILE* res, Solver& S, lbool ret)
+{
+    if (ret == l_True){
+        fprintf(res, "%s\n", MSG_SAT);
+        for (int i = 0; i < S.nVars(); i++)
+            if (S.model[i] != l_Undef)
+                fprintf(res, "%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
+        fprintf(res, " 0\n");
+    }else if (ret == l_False)
+        fprintf(res, "%s\n", MSG_UNSAT);
+    else
+        fprintf(res, "%s\n", MSG_INDET);
+}
+
+// 'auto_config' selects the profile per instance; otherwise 'profile' is used for all of them.
+static void solveBatchJob(BatchJob& job, BatchWorker& w, const char* out_dir, bool auto_config, SolverProfile profile)
+{
+    Solver S;
+    S.verbosity = 0;
+    {
+        std::lock_guard<std::mutex> lock(w.mtx);
+        pthread_getcpuclockid(pthread_self(), &w.cpu_clock);
+        w.cpu_start = threadCpuTime(w.cpu_clock);
+        w.start = std::chrono::steady_clock::now();
+        w.solver = &S; }
+
+    lbool ret = l_Undef;
+    bool  finished = false;
+    gzFile in = gzopen(job.path.c_str(), "rb");
+    if (in == NULL)
+        job.result = "NOFILE";
+    else{
+        // Failures are confined to this job so that the rest of the batch still completes:
+        try {
+            parse_DIMACS(in, S);
+            gzclose(in), in = NULL;
+            S.apply_profile(auto_config ? select_profile(S.extract_features()) : profile);
+            vec<Lit> dummy;
+            ret = S.solveLimited(dummy);
+            finished = true;
+            job.result = ret == l_True ? "SAT" : ret == l_False ? "UNSAT" : "INDET";
+        } catch (OutOfMemoryException&){
+            job.result = "MEMOUT";
+            fprintf(stderr, "%s: out of memory\n", job.path.c_str());
+        } catch (std::bad_alloc&){
+            job.result = "MEMOUT";
+            fprintf(stderr, "%s: out of memory\n", job.path.c_str());
+        } catch (std::exception& e){
+            job.result = "ERROR";
+            fprintf(stderr, "%s: %s\n", job.path.c_str(), e.what());
+        } catch (...){
+            job.result = "ERROR";
+            fprintf(stderr, "%s: unknown error\n", job.path.c_str()); }
+        if (in != NULL) gzclose(in); }
+
+    {
+        std::lock_guard<std::mutex> lock(w.mtx);
+        w.solver = nullptr; }
+    job.cpu       = threadCpuTime(w.cpu_clock) - w.cpu_start;
+    job.wall      = std::chrono::duration<double>(std::chrono::steady_clock::now() - w.start).count();
+    job.conflicts = S.conflicts;
+    job.mem       = S.mem_footprint() / (1024.0 * 1024.0);
+
+    if (out_dir != NULL && finished){
+        std::string name = job.path;
+        std::replace(name.begin(), name.end(), '/', '_');
+        std::string out_path = std::string(out_dir) + "/" + name + ".out";
+        FILE* res = fopen(out_path.c_str(), "wb");
+        if (res == NULL)
+            fprintf(stderr, "WARNING! Could not write %s\n", out_path.c_str());
+        else
+            writeResult(res, S, ret), fclose(res); }
+}
+
+// Solve all instances listed by 'source' on 'nthreads' threads; per-instance limits are in seconds
+// (0 = none). Writes a summary table to 'summary' (stdout if NULL).
+static int runBatch(const char* source, int nthreads, double wall_lim, double cpu_lim,
+                    const char* out_dir, const char* summary, bool auto_config, SolverProfile profile)
+{
+    std::vector<BatchJob> jobs;
+    if (!collectBatch(source, jobs))
+        fprintf(stderr, "ERROR! Could not read batch list: %s\n", source), exit(1);
+    if (out_dir != NULL){
+        std::error_code ec;
+        std::filesystem::create_directories(out_dir, ec); }
+    FILE* sum = summary == NULL ? stdout : fopen(summary, "w");
+    if (sum == NULL)
+        fprintf(stderr, "ERROR! Could not open summary file: %s\n", summary), exit(1);
+
+    // A malformed instance must not abort the whole batch:
+    parse_error_throws = true;
+
+    if (nthreads <= 0) nthreads = std::max<int>(std::thread::hardware_concurrency(), 1);
+    nthreads = std::min<int>(nthreads, std::max<int>(jobs.size(), 1));
+
+    std::vector<BatchWorker> workers(nthreads);
+    std::atomic<size_t>      next(0);
+    std::atomic<bool>        done(false);
+
+    // Enforce the per-instance limits by interrupting the solvers:
+    std::thread monitor([&](){
+        while (!done){
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            auto now = std::chrono::steady_clock::now();
+            for (auto& w : workers){
+                std::lock_guard<std::mutex> lock(w.mtx);
+                if (w.solver == nullptr) continue;
+                if ((wall_lim > 0 && std::chrono::duration<double>(now - w.start).count() > wall_lim) ||
+                    (cpu_lim > 0 && threadCpuTime(w.cpu_clock) - w.cpu_start > cpu_lim))
+                    w.solver->interrupt(); } } });
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; t++)
+        threads.emplace_back([&, t](){
+            for (size_t i; (i = next++) < jobs.size();)
+                solveBatchJob(jobs[i], workers[t], out_dir, auto_config, profile); });
+    for (auto& t : threads) t.join();
+    done = true;
+    monitor.join();
+
+    size_t width = 8;
+    for (auto& j : jobs) width = std::max(width, j.path.size());
+    fprintf(sum, "%-*s  %-6s  %10s  %10s  %12s  %10s\n", (int)width, "instance", "result", "wall(s)", "cpu(s)", "conflicts", "mem(MB)");
+    int nsat = 0, nunsat = 0;
+    for (auto& j : jobs){
+        fprintf(sum, "%-*s  %-6s  %10.3f  %10.3f  %12" PRIu64"  %10.2f\n", (int)width, j.path.c_str(), j.result, j.wall, j.cpu, j.conflicts, j.mem);
+        nsat   += strcmp(j.result, "SAT") == 0;
+        nunsat += strcmp(j.result, "UNSAT") == 0; }
+    fprintf(sum, "%d instances: %d SAT, %d UNSAT, %d other\n", (int)jobs.size(), nsat, nunsat, (int)jobs.size() - nsat - nunsat);
+    if (sum != stdout) fclose(sum);
+    return 0;
+}
+
+
 //=================================================================================================
 // Main:
 
@@ -83,9 +282,26 @@ int main(int argc, char** argv)
         IntOption    verb   ("MAIN", "verb",   "Verbosity level (0=silent, 1=some, 2=more).", 1, IntRange(0, 2));
         IntOption    cpu_lim("MAIN", "cpu-lim","Limit on CPU time allowed in seconds.\n", INT32_MAX, IntRange(0, INT32_MAX));
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", INT32_MAX, IntRange(0, INT32_MAX));
+        StringOption batch  ("MAIN", "batch",  "Solve all instances in this directory or list file (one path per line) and print a summary.");
+        IntOption    threads("MAIN", "batch-threads", "Number of threads in batch mode (0 = number of CPUs).", 0, IntRange(0, 1024));
+        DoubleOption batch_wall("MAIN", "batch-wall", "Wall clock limit per instance in batch mode (seconds, 0 = none).", 0, DoubleRange(0, true, HUGE_VAL, false));
+        DoubleOption batch_cpu ("MAIN", "batch-cpu",  "CPU time limit per instance in batch mode (seconds, 0 = none).", 0, DoubleRange(0, true, HUGE_VAL, false));
+        StringOption batch_out ("MAIN", "batch-out",  "Directory for per-instance result files in batch mode.");
+        StringOption batch_summary("MAIN", "batch-summary", "Write the batch summary table to this file instead of stdout.");
+        StringOption config ("MAIN", "config", "Search parameters: auto (chosen from instance features), default, random or leq. Options given explicitly always take precedence.", "default");
+        BoolOption   sweep  ("MAIN", "sweep",  "Substitute equivalent vars found by SAT sweeping before solving.", false);
+        StringOption dimacs ("MAIN", "dimacs", "If given, stop after root level simplification and write the result to this file (gzipped if the name ends with .gz).");
 
         parseOptions(argc, argv, true);
 
+        SolverProfile profile = SolverProfile::DEFAULT;
+        bool auto_config = strcmp(config, "auto") == 0;
+        if (!auto_config && !parse_profile(config, profile))
+            fprintf(stderr, "ERROR! Unknown config: %s\n", (const char*)config), exit(1);
+
+        if (batch)
+            return runBatch(batch, threads, batch_wall, batch_cpu, batch_out, batch_summary, auto_config, profile);
+
         Solver S;
         double initial_time = cpuTime();
 
@@ -116,7 +332,12 @@ int main(int argc, char** argv)
                 rl.rlim_cur = new_mem_lim;
                 if (setrlimit(RLIMIT_AS, &rl) == -1)
                     printf("WARNING! Could not set resource limit: Virtual memory.\n");
-            } }
+            }
+            // Degrade gracefully before the hard limit is hit; note that garbage collection
+            // temporarily holds two clause regions:
+            if (S.mem_target == 0)
+                S.mem_target = mem_lim / 2;
+        }
 
         if (argc == 1)
             printf("Reading from standard input... Use '--help' for help.\n");
@@ -139,6 +360,33 @@ int main(int argc, char** argv)
         signal(SIGINT, SIGINT_interrupt);
         signal(SIGXCPU,SIGINT_interrupt);
 
+        // Features are only extracted when they select the profile or are printed:
+        if (auto_config || S.verbosity > 0){
+            InstanceFeatures features = S.extract_features();
+            if (auto_config)
+                profile = select_profile(features);
+            if (S.verbosity > 0)
+                features.print(); }
+        S.apply_profile(profile);
+        if (S.verbosity > 0)
+            printf("|  Config: %-66s |\n", profile_name(profile));
+
+        if (dimacs){
+            if (S.verbosity > 0)
+                printf("==============================[ Writing DIMACS ]===============================\n");
+            // dead var removal drops constraints that the model of the
+            // written problem would still have to satisfy
+            S.incremental = true;
+            S.simplify();
+            S.toDimacs((const char*)dimacs);
+            if (S.verbosity > 0)
+                printStats(S);
+            exit(0);
+        }
+
+        if (sweep)
+            S.sat_sweep();
+
         vec<Lit> dummy;
         lbool ret = S.solveLimited(dummy);
         if (S.verbosity > 0) {
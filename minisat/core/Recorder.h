@@ -39,6 +39,7 @@ class ClauseRecorder {
     int m_nr_var = 0;
     std::vector<vec<Lit>> m_disj_clause;
     std::vector<IneqAssignClause> m_leq_assign_clause, m_geq_assign_clause;
+    std::vector<vec<Lit>> m_learnt_clause;
     mutable vec<Lit> m_add_tmp;
 
     void update_nr_var(Lit l) {
@@ -87,6 +88,17 @@ public:
         add_ineq_assign(m_geq_assign_clause.back(), lits, bound, dst);
     }
 
+    //! add a learnt clause implied by the recorded constraints; see
+    //! Solver::set_base_learnt_export()
+    void add_learnt(const vec<Lit>& lits) {
+        m_learnt_clause.emplace_back();
+        lits.copyTo(m_learnt_clause.back());
+
+        for (auto&& i : lits) {
+            update_nr_var(i);
+        }
+    }
+
     template <class Solver>
     void replay(Solver& solver) const {
         for (int i = 0; i < m_nr_var; ++i) {
@@ -103,6 +115,10 @@ public:
             solver.addGeqAssign_(mutable_lit(i.lits), i.bound, i.dst);
         }
 
+        for (auto&& i : m_learnt_clause) {
+            solver.import_learnt(mutable_lit(i));
+        }
+
         for (auto i : m_var_preference) {
             solver.setVarPreference(i.first, i.second);
         }
@@ -112,5 +128,8 @@ public:
 
     //! number of recorded vars
     int nr_var() const { return m_nr_var; }
+
+    //! number of recorded learnt clauses
+    int nr_learnt() const { return m_learnt_clause.size(); }
 };
 }  // namespace Minisat
@@ -0,0 +1,161 @@
+/**********************************************************************************[Relaxation.cc]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "minisat/core/Solver.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+
+using namespace Minisat;
+
+/*
+ * Each var becomes a value in [0, 1] and a lit its value or one minus it.
+ * A clause is the row sum(lits) >= 1, and an LEQ dst <=> (sum(lits) <= k)
+ * over n lits is linearized with big-M rows:
+ *
+ *      sum(lits) + (n - k) * dst <= n      (dst implies the LEQ)
+ *      sum(lits) + (k + 1) * dst >= k + 1  (~dst implies the negation)
+ *
+ * Violated rows are projected on in turn and the values are clipped to
+ * [0, 1] (the relaxation method of Agmon and of Motzkin and Schoenberg).
+ * Since all values at 1/2 satisfy every clause row, the plain relaxation
+ * says little, so each pass also pushes the values away from 1/2 by a small
+ * factor; the values start slightly off 1/2 towards the current polarities.
+ * A var that the rows keep close to 1/2 is one that the relaxation has no
+ * opinion on.
+ */
+
+namespace {
+//! max violation at which the relaxation counts as solved
+constexpr double LP_TOLERANCE = 1e-3;
+//! initial distance of the values from 1/2
+constexpr double LP_INIT_BIAS = 0.01;
+//! factor by which the distances from 1/2 grow in each pass
+constexpr double LP_SHARPEN = 1.1;
+}  // anonymous namespace
+
+void Solver::lp_guide() {
+    assert(decisionLevel() == 0);
+    std::vector<double> x(nVars());
+    for (Var v = 0; v < nVars(); ++v) {
+        if (value(v) != l_Undef) {
+            x[v] = value(v) == l_True;
+        } else {
+            x[v] = 0.5 + (polarity[v] ? -LP_INIT_BIAS : LP_INIT_BIAS);
+        }
+    }
+    auto lit_val = [&x](Lit p) {
+        return sign(p) ? 1 - x[var(p)] : x[var(p)];
+    };
+
+    // project on the row coef * sum(lits of c) + dst_coef * dst >= bound;
+    // return the violation before the projection
+    auto project = [&](const Clause& c, double coef, Lit dst, double dst_coef,
+                       double bound) {
+        double sum = 0, norm = 0;
+        for (int i = 0; i < c.size(); ++i) {
+            sum += coef * lit_val(c[i]);
+            norm += value(c[i]) == l_Undef;
+        }
+        norm *= coef * coef;
+        if (dst != lit_Undef) {
+            sum += dst_coef * lit_val(dst);
+            norm += (value(dst) == l_Undef) * dst_coef * dst_coef;
+        }
+        double viol = bound - sum;
+        if (viol <= LP_TOLERANCE || norm == 0) {
+            return std::max(viol, 0.0);
+        }
+        auto move = [&](Lit p, double delta) {
+            if (value(p) == l_Undef) {
+                double& xv = x[var(p)];
+                xv = std::min(std::max(xv + (sign(p) ? -delta : delta), 0.0),
+                              1.0);
+            }
+        };
+        double step = viol / norm;
+        for (int i = 0; i < c.size(); ++i) {
+            move(c[i], coef * step);
+        }
+        if (dst != lit_Undef) {
+            move(dst, dst_coef * step);
+        }
+        return viol;
+    };
+
+    int nr_sweeps = 0;
+    double max_viol = 0;
+    while (nr_sweeps < lp_sweeps) {
+        ++nr_sweeps;
+        max_viol = 0;
+        for (CRef cr : clauses) {
+            const Clause& c = ca[cr];
+            if (!c.is_leq()) {
+                max_viol = std::max(max_viol, project(c, 1, lit_Undef, 0, 1));
+                continue;
+            }
+            int n = c.size(), k = c.leq_bound();
+            max_viol = std::max(max_viol,
+                                project(c, -1, c.leq_dst(), k - n, -n));
+            max_viol = std::max(max_viol,
+                                project(c, 1, c.leq_dst(), k + 1, k + 1));
+        }
+        // stop once the rounded values satisfy the relaxation
+        bool integral = true;
+        for (Var v = 0; v < nVars(); ++v) {
+            if (value(v) == l_Undef) {
+                x[v] = std::min(
+                        std::max(0.5 + (x[v] - 0.5) * LP_SHARPEN, 0.0), 1.0);
+                integral &= x[v] == 0 || x[v] == 1;
+            }
+        }
+        if (max_viol <= LP_TOLERANCE && integral) {
+            break;
+        }
+    }
+
+    for (Var v = 0; v < nVars(); ++v) {
+        if (!decision[v] || value(v) != l_Undef) {
+            continue;
+        }
+        double conf = 2 * std::fabs(x[v] - 0.5);
+        if (conf < LP_TOLERANCE) {
+            continue;
+        }
+        ++lp_guided_vars;
+        polarity[v] = x[v] < 0.5;
+        // at most one bump, so that conflicts soon take over
+        varBumpActivity(v, conf * var_inc);
+        if (lp_pref && !var_preference[v]) {
+            var_preference[v] = -std::lround(conf * 1000);
+        }
+    }
+    if (lp_pref) {
+        rebuildOrderHeap();
+    }
+    if (verbosity > 0) {
+        printf("|  LP relaxation: %5d sweeps, max violation %8.3g, %12" PRIu64
+               " vars |\n",
+               nr_sweeps, max_viol, lp_guided_vars);
+    }
+}
@@ -0,0 +1,160 @@
+/***********************************************************************************[Scheduler.cc]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+
+#include "minisat/core/Scheduler.h"
+#include "minisat/utils/System.h"
+
+#include <algorithm>
+
+using namespace Minisat;
+
+bool SolveScheduler::JobOrder::operator()(
+        const std::shared_ptr<Job>& a, const std::shared_ptr<Job>& b) const {
+    if (policy == Policy::DEADLINE && a->deadline != b->deadline) {
+        return a->deadline < b->deadline;
+    }
+    if (a->priority != b->priority) {
+        return a->priority > b->priority;
+    }
+    return a->seq < b->seq;
+}
+
+SolveScheduler::SolveScheduler(int nr_threads, int64_t slice_propagations,
+                               Policy policy)
+        : m_slice_propagations{slice_propagations},
+          m_queue{JobOrder{policy}} {
+    minisat_uassert(slice_propagations > 0, "slice budget must be positive");
+    if (nr_threads <= 0) {
+        nr_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+    }
+    for (int i = 0; i < nr_threads; ++i) {
+        m_threads.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+SolveScheduler::~SolveScheduler() {
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stop = true;
+        for (auto& i : m_queue) {
+            i->queued = false;
+            finish(*i, l_Undef);
+        }
+        m_queue.clear();
+    }
+    // running jobs are finished by their threads after the slice
+    m_cv.notify_all();
+    for (auto& i : m_threads) {
+        i.join();
+    }
+}
+
+void SolveScheduler::finish(Job& job, lbool result) {
+    job.solver->reuse_trail = job.reuse_trail;
+    job.promise.set_value(result);
+}
+
+SolveScheduler::Ticket SolveScheduler::submit(Solver& solver,
+                                              const vec<Lit>& assumps,
+                                              int priority,
+                                              Clock::time_point deadline) {
+    auto job = std::make_shared<Job>();
+    job->solver = &solver;
+    assumps.copyTo(job->assumps);
+    job->priority = priority;
+    job->deadline = deadline;
+    job->reuse_trail = solver.reuse_trail;
+    solver.reuse_trail = true;
+    Ticket ticket{job, job->promise.get_future().share()};
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        minisat_uassert(!m_stop, "submit() to a stopped scheduler");
+        job->seq = m_seq++;
+        job->queued = true;
+        m_queue.insert(job);
+    }
+    m_cv.notify_one();
+    return ticket;
+}
+
+void SolveScheduler::cancel(const Ticket& ticket) {
+    Job& job = *ticket.job;
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if (job.queued) {
+        m_queue.erase(ticket.job);
+        job.queued = false;
+        finish(job, l_Undef);
+    } else if (job.running) {
+        job.canceled = true;
+        job.solver->interrupt();
+    }
+}
+
+int SolveScheduler::nr_pending() {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_queue.size() + m_nr_running;
+}
+
+uint64_t SolveScheduler::nr_slices() {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_nr_slices;
+}
+
+void SolveScheduler::worker_loop() {
+    std::unique_lock<std::mutex> lock{m_mutex};
+    for (;;) {
+        m_cv.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+        if (m_queue.empty()) {
+            return;
+        }
+        std::shared_ptr<Job> job = *m_queue.begin();
+        m_queue.erase(m_queue.begin());
+        job->queued = false;
+        if (Clock::now() >= job->deadline) {
+            finish(*job, l_Undef);
+            continue;
+        }
+        job->running = true;
+        ++m_nr_running;
+        ++m_nr_slices;
+        lock.unlock();
+
+        Solver& solver = *job->solver;
+        solver.budgetOff();
+        solver.setPropBudget(m_slice_propagations);
+        lbool ret = solver.solveLimited(job->assumps);
+
+        lock.lock();
+        job->running = false;
+        --m_nr_running;
+        // an interrupt by cancel() must not leak into later calls
+        solver.clearInterrupt();
+        if (ret.is_not_undef() || job->canceled || m_stop ||
+            Clock::now() >= job->deadline) {
+            finish(*job, ret);
+        } else {
+            job->seq = m_seq++;
+            job->queued = true;
+            m_queue.insert(job);
+        }
+    }
+}
@@ -0,0 +1,139 @@
+/************************************************************************************[Scheduler.h]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+
+#pragma once
+
+#include "minisat/core/Solver.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace Minisat {
+
+/*!
+ * time-slices the solve() calls of many solvers on a fixed pool of threads
+ *
+ * A slice is a solveLimited() call with a propagation budget. Learnts,
+ * activities and phases stay in the solver between slices, and
+ * Solver::reuse_trail is turned on while a job is pending so that the
+ * restart sequence, the learnt limit and the trail are kept as well, and
+ * each slice continues the search where the last one stopped. A solver must
+ * not be touched by the caller until its job is done.
+ */
+class SolveScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Policy {
+        //! higher priority first; jobs of equal priority take turns
+        PRIORITY,
+        //! earliest deadline first, then as PRIORITY
+        DEADLINE,
+    };
+
+    struct Job;
+
+    //! handle of a submitted job
+    struct Ticket {
+        std::shared_ptr<Job> job;
+        //! l_True or l_False, or l_Undef if the job has been canceled or has
+        //! missed its deadline
+        std::shared_future<lbool> result;
+    };
+
+private:
+    struct JobOrder {
+        Policy policy;
+        bool operator()(const std::shared_ptr<Job>& a,
+                        const std::shared_ptr<Job>& b) const;
+    };
+
+    const int64_t m_slice_propagations;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::set<std::shared_ptr<Job>, JobOrder> m_queue;
+    uint64_t m_seq = 0, m_nr_slices = 0;
+    int m_nr_running = 0;
+    bool m_stop = false;
+    std::vector<std::thread> m_threads;
+
+    void worker_loop();
+    //! set the result of a job that is neither queued nor running
+    static void finish(Job& job, lbool result);
+
+public:
+    /*!
+     * \param nr_threads number of threads (0 for the number of CPUs)
+     * \param slice_propagations propagation budget of a slice
+     */
+    explicit SolveScheduler(int nr_threads,
+                            int64_t slice_propagations = 10000,
+                            Policy policy = Policy::DEADLINE);
+    //! cancel the remaining jobs and stop the threads
+    ~SolveScheduler();
+
+    SolveScheduler(const SolveScheduler&) = delete;
+    SolveScheduler& operator=(const SolveScheduler&) = delete;
+
+    /*!
+     * solve @p solver under @p assumps asynchronously
+     *
+     * \param deadline the job is finished with l_Undef at the first slice
+     *      boundary after the deadline
+     */
+    Ticket submit(Solver& solver, const vec<Lit>& assumps, int priority = 0,
+                  Clock::time_point deadline = Clock::time_point::max());
+
+    //! cancel a job: a queued job is finished at once, and a running one is
+    //! interrupted; no effect if the job is already done
+    void cancel(const Ticket& ticket);
+
+    //! number of jobs that are queued or running
+    int nr_pending();
+
+    //! total number of slices run
+    uint64_t nr_slices();
+};
+
+struct SolveScheduler::Job {
+    Solver* solver;
+    vec<Lit> assumps;
+    int priority;
+    Clock::time_point deadline;
+    //! order among jobs with equal keys; renewed after each slice so that
+    //! they take turns
+    uint64_t seq = 0;
+    //! value of Solver::reuse_trail to restore when the job is done
+    bool reuse_trail = false;
+    //! states protected by the mutex of the scheduler
+    bool queued = false, running = false, canceled = false;
+    std::promise<lbool> promise;
+};
+
+}  // namespace Minisat
@@ -0,0 +1,162 @@
+/***************************************************************************************[Slice.cc]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "minisat/core/Solver.h"
+
+#include <algorithm>
+
+using namespace Minisat;
+
+/*
+ * The gates outside of the cone are acyclic definitions of vars that no
+ * remaining constraint refers to, so any assignment of the cone that
+ * satisfies its constraints extends to a model of the whole problem by
+ * evaluating them in topological order. Their constraints stay attached and
+ * may propagate, but their vars are not decided, so the search stops once the
+ * cone is assigned. Learnt clauses are implied by the whole problem; the
+ * extended model satisfies them even if the search assigned the vars outside
+ * of the cone differently.
+ *
+ * The gate network only changes with the constraints. It is extracted again
+ * when constraints have been added or a scope has been popped; removing
+ * satisfied constraints or the LEQs of dead vars keeps the gates valid, and
+ * at worst leaves more vars in the cone.
+ */
+
+void Solver::update_slice_net() {
+    if (slice_net_valid && slice_net_added == added_constraints) {
+        return;
+    }
+    slice_net_valid = true;
+    slice_net_added = added_constraints;
+    extract_gates(slice_net);
+
+    std::vector<CRef> defs = slice_net.crefs;
+    std::sort(defs.begin(), defs.end());
+    slice_base.assign(nVars(), 0);
+    for (CRef cr : clauses) {
+        if (std::binary_search(defs.begin(), defs.end(), cr)) {
+            continue;
+        }
+        const Clause& c = ca[cr];
+        for (int i = 0; i < c.size(); ++i) {
+            slice_base[var(c[i])] = 1;
+        }
+        if (c.is_leq()) {
+            slice_base[var(c.leq_dst())] = 1;
+        }
+    }
+    // the refs are invalidated by garbage collection
+    slice_net.crefs.clear();
+}
+
+void Solver::slice_query() {
+    slice_gates.clear();
+    slice_vars.clear();
+    update_slice_net();
+    if (slice_net.gates.empty()) {
+        return;
+    }
+
+    // vars created after the extraction are not used by any constraint yet
+    std::vector<char> in_cone(slice_base);
+    in_cone.resize(nVars(), 0);
+    std::vector<Var> queue;
+    auto add = [&](Var v) {
+        if (!in_cone[v]) {
+            in_cone[v] = 1;
+            queue.push_back(v);
+        }
+    };
+    for (Var v = 0; v < int(slice_base.size()); ++v) {
+        if (slice_base[v]) {
+            queue.push_back(v);
+        }
+    }
+    for (Lit p : assumptions) {
+        add(var(p));
+    }
+    for (const XorConstraint& x : xors) {
+        for (Var v : x.vars) {
+            add(v);
+        }
+    }
+    for (size_t i = 0; i < queue.size(); ++i) {
+        Var v = queue[i];
+        int g = v < int(slice_net.gate_of.size()) ? slice_net.gate_of[v] : -1;
+        if (g != -1) {
+            const GateNetwork::Gate& gate = slice_net.gates[g];
+            const Lit* lits = slice_net.gate_lits(gate);
+            for (int j = 0; j < gate.size; ++j) {
+                add(var(lits[j]));
+            }
+        }
+    }
+
+    int nr_constraints = 0;
+    for (int g = 0; g < int(slice_net.gates.size()); ++g) {
+        const GateNetwork::Gate& gate = slice_net.gates[g];
+        if (!in_cone[var(gate.out)]) {
+            slice_gates.push_back(g);
+            nr_constraints += gate.nr_crefs;
+        }
+    }
+    if (slice_gates.empty()) {
+        return;
+    }
+
+    for (Var v = 0; v < nVars(); ++v) {
+        if (!in_cone[v] && decision[v]) {
+            setDecisionVar(v, false);
+            slice_vars.push(v);
+        }
+    }
+    sliced_solves++;
+    sliced_constraints += nr_constraints;
+}
+
+void Solver::extend_sliced_model() {
+    // inputs that only feed gates outside of the cone can take any value
+    for (Var v : slice_vars) {
+        if (model[v] == l_Undef) {
+            model[v] = l_False;
+        }
+    }
+    for (int g : slice_gates) {
+        const GateNetwork::Gate& gate = slice_net.gates[g];
+        // inputs left open by a partial model
+        const Lit* lits = slice_net.gate_lits(gate);
+        for (int i = 0; i < gate.size; ++i) {
+            if (model[var(lits[i])] == l_Undef) {
+                model[var(lits[i])] = l_False;
+            }
+        }
+        model[var(gate.out)] = lbool(slice_net.eval(gate, model));
+    }
+}
+
+void Solver::unslice_query() {
+    for (Var v : slice_vars) {
+        setDecisionVar(v, true);
+    }
+    slice_vars.clear();
+    slice_gates.clear();
+}
@@ -23,10 +23,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "minisat/core/Solver.h"
 #include "minisat/mtl/Sort.h"
 #include "minisat/utils/Options.h"
+#include "minisat/utils/OutputBuffer.h"
 #include "minisat/utils/System.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <memory>
 #include <stdexcept>
 
 using namespace Minisat;
@@ -84,6 +87,117 @@ static DoubleOption opt_garbage_frac(_cat, "gc-frac",
                                      "before a garbage collection is triggered",
                                      0.20,
                                      DoubleRange(0, false, HUGE_VAL, false));
+static IntOption opt_gc_threads(
+        _cat, "gc-threads",
+        "Number of helper threads for garbage collection and level-0 cleanup",
+        0, IntRange(0, 256));
+static BoolOption opt_incremental(
+        _cat, "incremental",
+        "Allow adding constraints after solve() or during search", false);
+static BoolOption opt_reuse_trail(
+        _cat, "reuse-trail",
+        "Keep the trail of common assumption prefixes or of interrupted "
+        "searches, and the restart state, between solve() calls",
+        false);
+static IntOption opt_mem_target(
+        _cat, "mem-target",
+        "Soft limit on the memory footprint in megabytes; learnts are reduced "
+        "to stay below it (0 to disable)",
+        0, IntRange(0, INT32_MAX));
+static DoubleOption opt_inproc_effort(
+        _cat, "inproc-effort",
+        "Max number of literals scanned by inprocessing per propagation", 0.1,
+        DoubleRange(0, false, HUGE_VAL, false));
+static IntOption opt_sweep_words(
+        _cat, "sweep-words",
+        "Number of 64-bit random simulation words per var in SAT sweeping", 4,
+        IntRange(1, 1024));
+static IntOption opt_sweep_conflicts(
+        _cat, "sweep-confl",
+        "Conflict budget of each SAT call in SAT sweeping", 1000,
+        IntRange(1, INT32_MAX));
+static Int64Option opt_sweep_max_conflicts(
+        _cat, "sweep-max-confl",
+        "Total conflict budget of SAT sweeping (0 for no limit)", 100000,
+        Int64Range(0, INT64_MAX));
+static BoolOption opt_slice(
+        _cat, "slice",
+        "Restrict solving under assumptions to the cone of influence of the "
+        "assumptions and of the constraints that do not define a gate",
+        false);
+static BoolOption opt_partial_model(
+        _cat, "partial-model",
+        "Stop as soon as all constraints are satisfied and leave the other "
+        "vars undefined in the model",
+        false);
+static BoolOption opt_xor_detect(
+        _cat, "xor",
+        "Detect XOR constraints in the clauses and reason on them by "
+        "Gauss-Jordan elimination",
+        false);
+static BoolOption opt_leq_pairs(
+        _cat, "leq-pairs",
+        "Derive binary relations between the dsts of LEQs with overlapping "
+        "lits",
+        false);
+static Int64Option opt_leq_pair_ticks(
+        _cat, "leq-pair-ticks",
+        "Max number of occurrences visited to derive relations between LEQs",
+        10000000, Int64Range(0, INT64_MAX));
+static BoolOption opt_symmetry(
+        _cat, "sym",
+        "Detect symmetries of the constraints and add lex-leader constraints "
+        "to break them",
+        false);
+static Int64Option opt_sym_ticks(
+        _cat, "sym-ticks",
+        "Max number of graph edges visited by the symmetry search", 100000000,
+        Int64Range(0, INT64_MAX));
+static IntOption opt_sym_lex_size(
+        _cat, "sym-lex-size",
+        "Max number of vars in the lex-leader constraint of each symmetry", 50,
+        IntRange(1, INT32_MAX));
+static BoolOption opt_lp_phase(
+        _cat, "lp-phase",
+        "Set initial phases and activities from an approximate solution of "
+        "the linear relaxation",
+        false);
+static IntOption opt_lp_sweeps(
+        _cat, "lp-sweeps",
+        "Max number of passes over the constraints to solve the relaxation",
+        50, IntRange(1, INT32_MAX));
+static BoolOption opt_lp_pref(
+        _cat, "lp-pref",
+        "Also set var preferences from the confidence of the relaxation",
+        false);
+static BoolOption opt_td_order(
+        _cat, "td-order",
+        "Prefer deciding vars in a min-degree elimination order, which "
+        "defines an approximate tree decomposition",
+        false);
+static Int64Option opt_td_ticks(
+        _cat, "td-ticks",
+        "Max ticks of the elimination order; the remaining vars are ordered "
+        "by degree",
+        10000000, Int64Range(0, INT64_MAX));
+static BoolOption opt_bg_simp(
+        _cat, "bg-simp",
+        "Subsume, probe and vivify snapshots of the clause database in a "
+        "helper thread and apply the results at restarts",
+        false);
+static IntOption opt_bg_simp_interval(
+        _cat, "bg-simp-interval",
+        "Min number of conflicts between two bg-simp snapshots", 10000,
+        IntRange(0, INT32_MAX));
+static Int64Option opt_bg_simp_ticks(
+        _cat, "bg-simp-ticks",
+        "Propagation and subsumption budget of one bg-simp round", 20000000,
+        Int64Range(0, INT64_MAX));
+static IntOption opt_result_cache(
+        _cat, "result-cache",
+        "Number of UNSAT cores and models kept to answer repeated queries "
+        "(0 to disable)",
+        0, IntRange(0, INT32_MAX));
 
 /* ================== LeqWatcher ================== */
 //! watcher for LEQ clauses
@@ -285,6 +399,12 @@ void DeadVarRemover::simplify() {
     std::sort(m_var2cref.begin(), m_var2cref.end());
 
     RefCnt* refcnt = m_var_refcnt.data();
+    for (const XorConstraint& x : m_solver->xors) {
+        for (Var v : x.vars) {
+            // XOR vars are not referenced by clauses
+            refcnt[v].tot = -1;
+        }
+    }
     const lbool* assigns = m_solver->assigns.data();
     for (int i = 0; i < nr_var; ++i) {
         if (assigns[i] != l_Undef) {
@@ -307,6 +427,7 @@ void DeadVarRemover::simplify() {
 
     clean_removed(m_solver->clauses);
     clean_removed(m_solver->learnts);
+    m_applied |= m_to_remove.size() > 0;
 }
 
 void DeadVarRemover::fix_var_assignments() {
@@ -316,7 +437,13 @@ void DeadVarRemover::fix_var_assignments() {
         int cnt = 0;
         for (Lit l : clause.lits) {
             auto val = m_solver->value(l);
-            assert(val.is_not_undef());
+            if (val == l_Undef) {
+                // left open by a partial model; all remaining constraints
+                // are satisfied, so the value is arbitrary
+                assert(m_solver->partial_model);
+                m_solver->uncheckedEnqueue(~l);
+                val = l_False;
+            }
             cnt += (val == l_True);
         }
         Lit dst = clause.dst;
@@ -331,6 +458,84 @@ void DeadVarRemover::fix_var_assignments() {
     m_leq_to_fix.clear();
 }
 
+/* ================== ResultCache ================== */
+const vec<Lit>* ResultCache::find_core(const vec<Lit>& assumps) {
+    if (m_cores.empty()) {
+        return nullptr;
+    }
+    uint64_t sig = 0;
+    for (Lit p : assumps) {
+        sig |= signature(p);
+        m_mark.growTo(toInt(p) + 1, 0);
+        m_mark[toInt(p)] = 1;
+    }
+    const vec<Lit>* ret = nullptr;
+    for (auto&& core : m_cores) {
+        if (core.sig & ~sig) {
+            continue;
+        }
+        bool subset = true;
+        for (Lit p : core.lits) {
+            if (toInt(p) >= m_mark.size() || !m_mark[toInt(p)]) {
+                subset = false;
+                break;
+            }
+        }
+        if (subset) {
+            ret = &core.lits;
+            break;
+        }
+    }
+    for (Lit p : assumps) {
+        m_mark[toInt(p)] = 0;
+    }
+    return ret;
+}
+
+const vec<lbool>* ResultCache::find_model(const vec<Lit>& assumps) const {
+    for (auto&& model : m_models) {
+        bool sat = true;
+        for (Lit p : assumps) {
+            if (var(p) >= model.size() || !model[var(p)].is_boolv(!sign(p))) {
+                sat = false;
+                break;
+            }
+        }
+        if (sat) {
+            return &model;
+        }
+    }
+    return nullptr;
+}
+
+void ResultCache::add_core(const vec<Lit>& core) {
+    Core* dst;
+    if (static_cast<int>(m_cores.size()) < m_capacity) {
+        m_cores.emplace_back();
+        dst = &m_cores.back();
+    } else {
+        dst = &m_cores[m_core_next];
+        m_core_next = (m_core_next + 1) % m_capacity;
+    }
+    core.copyTo(dst->lits);
+    dst->sig = 0;
+    for (Lit p : core) {
+        dst->sig |= signature(p);
+    }
+}
+
+void ResultCache::add_model(const vec<lbool>& model) {
+    vec<lbool>* dst;
+    if (static_cast<int>(m_models.size()) < m_capacity) {
+        m_models.emplace_back();
+        dst = &m_models.back();
+    } else {
+        dst = &m_models[m_model_next];
+        m_model_next = (m_model_next + 1) % m_capacity;
+    }
+    model.copyTo(*dst);
+}
+
 //=================================================================================================
 // Constructor/Destructor:
 
@@ -349,6 +554,30 @@ Solver::Solver()
           rnd_pol(opt_rnd_pol),
           rnd_init_act(opt_rnd_init_act),
           garbage_frac(opt_garbage_frac),
+          gc_threads(opt_gc_threads),
+          incremental(opt_incremental),
+          reuse_trail(opt_reuse_trail),
+          mem_target(opt_mem_target),
+          inproc_effort(opt_inproc_effort),
+          sweep_words(opt_sweep_words),
+          sweep_conflicts(opt_sweep_conflicts),
+          sweep_max_conflicts(opt_sweep_max_conflicts),
+          slice(opt_slice),
+          partial_model(opt_partial_model),
+          xor_detect(opt_xor_detect),
+          leq_pairs(opt_leq_pairs),
+          leq_pair_ticks(opt_leq_pair_ticks),
+          symmetry(opt_symmetry),
+          sym_ticks(opt_sym_ticks),
+          sym_lex_size(opt_sym_lex_size),
+          lp_phase(opt_lp_phase),
+          lp_sweeps(opt_lp_sweeps),
+          lp_pref(opt_lp_pref),
+          td_order(opt_td_order),
+          td_ticks(opt_td_ticks),
+          bg_simp(opt_bg_simp),
+          bg_simp_interval(opt_bg_simp_interval),
+          bg_simp_ticks(opt_bg_simp_ticks),
           restart_first(opt_restart_first),
           restart_inc(opt_restart_inc)
 
@@ -377,7 +606,26 @@ Solver::Solver()
           clauses_literals(0),
           learnts_literals(0),
           max_literals(0),
-          tot_literals(0)
+          tot_literals(0),
+          added_constraints(0),
+          cache_hits(0),
+          mem_reductions(0),
+          mem_over_target(false),
+          sliced_solves(0),
+          sliced_constraints(0),
+          xor_propagations(0),
+          xor_conflicts(0),
+          xor_pivots(0),
+          leq_pair_binaries(0),
+          leq_pair_units(0),
+          sym_generators(0),
+          sym_clauses(0),
+          lp_guided_vars(0),
+          td_width(0),
+          bg_simp_rounds(0),
+          bg_simp_units(0),
+          bg_simp_strengthened(0),
+          bg_simp_deleted(0)
 
           ,
           ok(true),
@@ -399,6 +647,7 @@ Solver::Solver()
           propagation_budget(-1),
           asynch_interrupt(false),
 
+          result_cache(opt_result_cache),
           random_state{static_cast<uint64_t>(opt_random_seed)}
 
 {
@@ -408,6 +657,31 @@ Solver::Solver()
 
 Solver::~Solver() = default;
 
+void Solver::apply_profile(SolverProfile profile) {
+    auto set = [](const auto& opt, auto& field, auto value) {
+        if (!opt.isGiven()) {
+            field = value;
+        }
+    };
+    switch (profile) {
+        case SolverProfile::DEFAULT:
+            break;
+        case SolverProfile::RANDOM:
+            // saved phases and frequent restarts do not pay off without
+            // structure
+            set(opt_phase_saving, phase_saving, 0);
+            set(opt_luby_restart, luby_restart, false);
+            set(opt_restart_inc, restart_inc, 1.5);
+            break;
+        case SolverProfile::LEQ:
+            // LEQ propagation needs longer runs between restarts to make
+            // progress
+            set(opt_luby_restart, luby_restart, false);
+            set(opt_restart_inc, restart_inc, 1.5);
+            break;
+    }
+}
+
 /* ================== setters ================== */
 
 void Solver::setDecisionVar(Var v, bool b) {
@@ -448,6 +722,8 @@ Var Solver::newVar(bool sign, bool dvar) {
     activity.push(rnd_init_act ? random_state.uniform() * 0.00001 : 0);
     var_preference.push(0);
     seen.push(0);
+    is_scope_var.push(0);
+    root_taint.push(0);
     polarity.push(sign);
     decision.push();
     trail.capacity(v + 1);
@@ -456,43 +732,72 @@ Var Solver::newVar(bool sign, bool dvar) {
 }
 
 bool Solver::addClause_(vec<Lit>& ps) {
-    assert(decisionLevel() == 0);
-    if (!ok)
-        return false;
+    if (scopes.size()) {
+        ps.push(~mkLit(scopes.last().selector));
+    }
+    return addClauseNoGuard_(ps);
+}
 
-    // Check if clause is satisfied and remove false/duplicate literals:
+bool Solver::remove_root_lits(vec<Lit>& ps) {
+    // Check if clause is satisfied and remove false/duplicate literals; only
+    // top-level values are used since we might be in the middle of search
     sort(ps);
     Lit p;
     int i, j;
     for (i = j = 0, p = lit_Undef; i < ps.size(); i++) {
         minisat_uassert(var(ps[i]) < nVars(), "var=%d nVars=%d", var(ps[i]),
                         nVars());
-        if (value(ps[i]) == l_True || ps[i] == ~p)
-            return true;
-        else if (value(ps[i]) != l_False && ps[i] != p)
+        lbool v = rootValue(ps[i]);
+        if (v == l_True || ps[i] == ~p)
+            return false;
+        else if (v != l_False && ps[i] != p)
             ps[j++] = p = ps[i];
     }
     ps.shrink(i - j);
+    return true;
+}
+
+bool Solver::addClauseNoGuard_(vec<Lit>& ps, bool taint) {
+    if (!ok)
+        return false;
+
+    add_taint = taint || constraint_taint(ps);
+    if (!remove_root_lits(ps)) {
+        return true;
+    }
+    added_constraints++;
 
     if (ps.size() == 0)
         return ok = false;
     else if (ps.size() == 1) {
-        uncheckedEnqueue(ps[0]);
+        cancelUntil(0);
+        uncheckedEnqueue(ps[0], CRef_Undef, add_taint);
         return ok = (propagate() == CRef_Undef);
     } else {
         CRef cr = ca.alloc(ps, false);
+        ca[cr].tainted(add_taint);
         clauses.push(cr);
-        attachClause(cr);
+        if (decisionLevel() == 0) {
+            attachClause(cr);
+        } else {
+            attachClauseInSearch(cr);
+        }
     }
 
     return true;
 }
 
 template <bool src_neg>
-bool Solver::addClauseReifiedConjunction(Lit dst, const Lit* src, int size) {
+bool Solver::addClauseReifiedConjunction(Lit dst, const Lit* src, int size,
+                                         bool taint) {
     static_assert(src_neg == 0 || src_neg == 1);
+    // this is used for simplification of existing constraints, so the guard
+    // of current scope should not be added
     for (int i = 0; i < size; ++i) {
-        if (!addClause(~dst, src[i] ^ src_neg)) {
+        add_tmp.clear();
+        add_tmp.push(~dst);
+        add_tmp.push(src[i] ^ src_neg);
+        if (!addClauseNoGuard_(add_tmp, taint)) {
             return false;
         }
     }
@@ -501,24 +806,223 @@ bool Solver::addClauseReifiedConjunction(Lit dst, const Lit* src, int size) {
     for (int i = 0; i < size; ++i) {
         add_tmp.push(src[i] ^ (!src_neg));
     }
-    return addClause_(add_tmp);
+    return addClauseNoGuard_(add_tmp, taint);
 }
 
 bool Solver::addLeqAssign_(vec<Lit>& ps, int bound, Lit dst) {
-    assert(decisionLevel() == 0);
+    if (!scopes.size()) {
+        return addLeqAssignNoGuard_(ps, bound, dst);
+    }
+    // An LEQ assignment to a fresh var is only a definition and can not make
+    // the problem unsatisfiable, so only its equivalence to dst is guarded
+    Lit def = mkLit(newScopeVar(true));
+    if (!addLeqAssignNoGuard_(ps, bound, def)) {
+        return false;
+    }
+    return addClause(~def, dst) && addClause(def, ~dst);
+}
+
+bool Solver::addLeqAssignNoGuard_(vec<Lit>& ps, int bound, Lit dst) {
     if (!ok)
         return false;
 
+    add_taint = constraint_taint(ps) ||
+                (track_taint && rootValue(dst) != l_Undef &&
+                 root_taint[var(dst)]);
     canonize_leq_clause(ps, bound);
     minisat_uassert(var(dst) < nVars(), "var=%d nVars=%d", var(dst), nVars());
+    added_constraints++;
     if (auto r = try_leq_clause_const_prop(ps, dst, bound); r.has_value()) {
         return r.value();
     }
     assert(0 <= bound && bound < ps.size());
+
+    if (decisionLevel()) {
+        // LeqStatus counters can only be maintained for assignments made after
+        // the clause is added, so backtrack to the level before any involved
+        // var was assigned (lits have no top-level values after canonize)
+        int bt_level = decisionLevel();
+        auto update_bt = [this, &bt_level](Lit p) {
+            if (value(p) != l_Undef && level(var(p)) > 0) {
+                bt_level = std::min(bt_level, level(var(p)) - 1);
+            }
+        };
+        for (Lit p : ps) {
+            update_bt(p);
+        }
+        update_bt(dst);
+        cancelUntil(bt_level);
+    }
+
     add_leq_and_setup_watchers(ps, dst, bound);
     return true;
 }
 
+Var Solver::newScopeVar(bool dvar) {
+    assert(scopes.size());
+    Var v = newVar(true, dvar);
+    scope_vars.push(v);
+    is_scope_var[v] = 1;
+    return v;
+}
+
+void Solver::push() {
+    minisat_uassert(!dead_var_remover.applied(),
+                    "scopes can not be used after dead vars have been removed; "
+                    "set incremental before solving");
+    minisat_uassert(substituted_vars.empty(),
+                    "scopes can not be used after SAT sweeping");
+    incremental = true;
+    int vars_begin = scope_vars.size();
+    // the selector is always assumed, so it is not a decision var
+    scopes.push({var_Undef, vars_begin});
+    scopes.last().selector = newScopeVar(false);
+}
+
+void Solver::pop() {
+    minisat_uassert(scopes.size(), "pop() without matching push()");
+    cancelUntil(0);
+    // removing constraints may turn cached UNSAT results into SAT
+    result_cache.invalidate_cores();
+    bg_simp_epoch++;
+    // the removed constraints may define gates
+    slice_net_valid = false;
+    int vars_begin = scopes.last().vars_begin;
+    scopes.pop();
+
+    for (int i = vars_begin; i < scope_vars.size(); i++) {
+        seen[scope_vars[i]] = 1;
+    }
+    // learnt clauses depending on guarded constraints contain the negation of
+    // the selector (which is a decision var), and those depending on
+    // definition LEQs contain the defined var unless it has been resolved
+    // away, in which case the learnt is implied by the remaining problem
+    removeScopeClauses(clauses);
+    removeScopeClauses(learnts);
+    for (int i = vars_begin; i < scope_vars.size(); i++) {
+        Var v = scope_vars[i];
+        seen[v] = 0;
+        is_scope_var[v] = 0;
+        setDecisionVar(v, false);
+    }
+    scope_vars.shrink(scope_vars.size() - vars_begin);
+
+    // mod logs at level 0 are never reverted, and they may refer to removed
+    // LEQs
+    trail_leq_stat.clear();
+    watches.cleanAll();
+    leq_watches.cleanAll();
+    checkGarbage();
+}
+
+void Solver::removeScopeClauses(vec<CRef>& cs) {
+    int i, j;
+    for (i = j = 0; i < cs.size(); i++) {
+        const Clause& c = ca[cs[i]];
+        bool rm = c.is_leq() && seen[var(c.leq_dst())];
+        for (int k = 0; !rm && k < c.size(); k++) {
+            rm = seen[var(c[k])];
+        }
+        if (rm) {
+            removeClause(cs[i]);
+        } else {
+            cs[j++] = cs[i];
+        }
+    }
+    cs.shrink(i - j);
+}
+
+void Solver::set_adding_base(bool flag) {
+    adding_base = flag;
+    if (!flag) {
+        track_taint = true;
+    }
+}
+
+void Solver::set_base_learnt_export(int max_lbd, int max_size) {
+    minisat_uassert(!dead_var_remover.applied(),
+                    "learnt export can not be enabled after dead vars have "
+                    "been removed; set incremental before solving");
+    minisat_uassert(!scopes.size(),
+                    "learnt export can not be enabled inside a scope");
+    incremental = true;
+    track_taint = true;
+    export_max_lbd = max_lbd;
+    export_max_size = max_size;
+}
+
+bool Solver::import_learnt(vec<Lit>& ps, bool taint) {
+    if (!ok)
+        return false;
+
+    add_taint = taint || constraint_taint(ps);
+    if (!remove_root_lits(ps)) {
+        return true;
+    }
+
+    if (ps.size() == 0)
+        return ok = false;
+    if (ps.size() == 1) {
+        cancelUntil(0);
+        uncheckedEnqueue(ps[0], CRef_Undef, add_taint);
+        return ok = (propagate() == CRef_Undef);
+    }
+    CRef cr = ca.alloc(ps, true);
+    ca[cr].tainted(add_taint);
+    learnts.push(cr);
+    if (decisionLevel() == 0) {
+        attachClause(cr);
+    } else {
+        attachClauseInSearch(cr);
+    }
+    claBumpActivity(ca[cr]);
+    return true;
+}
+
+bool Solver::root_reason_taint(const Clause& c) const {
+    // vars that are not assigned at root level always have zero root taint
+    if (c.tainted()) {
+        return true;
+    }
+    for (int i = 0; i < c.size(); i++) {
+        if (root_taint[var(c[i])]) {
+            return true;
+        }
+    }
+    return c.is_leq() && root_taint[var(c.leq_dst())];
+}
+
+bool Solver::constraint_taint(const vec<Lit>& ps) const {
+    if (!track_taint) {
+        return false;
+    }
+    if (!adding_base || scopes.size()) {
+        return true;
+    }
+    for (Lit p : ps) {
+        if (root_taint[var(p)]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Solver::should_export_learnt(const vec<Lit>& ps) {
+    if (ps.size() > export_max_size) {
+        return false;
+    }
+    // learnts to be exported are short, so the quadratic count is cheap
+    int lbd = 0;
+    for (int i = 0; i < ps.size(); i++) {
+        int lv = level(var(ps[i])), j = 0;
+        while (j < i && level(var(ps[j])) != lv) {
+            j++;
+        }
+        lbd += j == i;
+    }
+    return lbd <= export_max_lbd;
+}
+
 void Solver::canonize_leq_clause(vec<Lit>& ps, int& bound) {
     sort(ps);
     Lit p;
@@ -526,12 +1030,13 @@ void Solver::canonize_leq_clause(vec<Lit>& ps, int& bound) {
     for (i = j = 0, p = lit_Undef; i < ps.size(); i++) {
         minisat_uassert(var(ps[i]) < nVars(), "var=%d nVars=%d", var(ps[i]),
                         nVars());
-        if (value(ps[i]) == l_True) {
+        lbool v = rootValue(ps[i]);
+        if (v == l_True) {
             --bound;
             continue;
         }
 
-        if (value(ps[i]) == l_False) {
+        if (v == l_False) {
             continue;
         }
 
@@ -560,12 +1065,15 @@ std::optional<bool> Solver::try_leq_clause_const_prop(const vec<Lit>& ps,
         val = l_False;
     }
     if (val != l_Undef) {
-        if (value(dst) == l_Undef) {
+        lbool dst_val = rootValue(dst);
+        if (dst_val == l_Undef) {
             // setup the value for dst
-            uncheckedEnqueue(val == l_True ? dst : ~dst);
+            cancelUntil(0);
+            uncheckedEnqueue(val == l_True ? dst : ~dst, CRef_Undef,
+                             add_taint);
             return ok = (propagate() == CRef_Undef);
         }
-        if (value(dst).is_boolv(val.as_bool())) {
+        if (dst_val.is_boolv(val.as_bool())) {
             return true;
         }
         return ok = false;
@@ -578,6 +1086,7 @@ void Solver::add_leq_and_setup_watchers(vec<Lit>& ps, Lit dst, int bound) {
     minisat_uassert(ps.size() < MAX_LEQ_SIZE, "LEQ too large: get %d, max %d",
                     ps.size(), MAX_LEQ_SIZE);
     CRef cr = ca.alloc(ps, false, dst, bound);
+    ca[cr].tainted(add_taint);
     clauses.push(cr);
     assert(ca.ael(&ca[cr].leq_status()) - cr ==
            ps.size() + LeqStatus::OFFSET_IN_CLAUSE);
@@ -624,6 +1133,44 @@ void Solver::attachClause(CRef cr) {
         clauses_literals += c.size();
 }
 
+void Solver::attachClauseInSearch(CRef cr) {
+    Clause& c = ca[cr];
+    assert(!c.is_leq() && c.size() > 1);
+
+    // a lit is a better watch if it is not false, or is falsified later
+    auto better = [this](Lit a, Lit b) {
+        return value(b) == l_False &&
+               (value(a) != l_False || level(var(a)) > level(var(b)));
+    };
+    for (int k = 0; k < 2; k++) {
+        for (int i = k + 1; i < c.size(); i++) {
+            if (better(c[i], c[k])) {
+                std::swap(c[i], c[k]);
+            }
+        }
+    }
+    attachClause(cr);
+
+    if (value(c[1]) != l_False) {
+        return;
+    }
+    // all lits other than c[0] are false, and c[1] is the latest one
+    int lv1 = level(var(c[1]));
+    lbool v0 = value(c[0]);
+    if (v0 == l_True && level(var(c[0])) <= lv1) {
+        return;
+    }
+    if (v0 == l_False && level(var(c[0])) == lv1) {
+        // conflicting at the level of c[1]: undo it so both watches are free
+        assert(lv1 > 0);
+        cancelUntil(lv1 - 1);
+        return;
+    }
+    // the clause is unit at level lv1
+    cancelUntil(lv1);
+    uncheckedEnqueue(c[0], cr);
+}
+
 void Solver::detachClause(CRef cr, bool strict) {
     const Clause& c = ca[cr];
     assert(!c.is_leq());
@@ -726,6 +1273,14 @@ void Solver::cancelUntil(int level) {
             s.clear_imply_type_with(log.imply_type_clear);
         }
 
+        while (!sat_scan.empty() && sat_scan.back().first > level) {
+            sat_scan.pop_back();
+        }
+        while (!xor_reasons.empty() && xor_reasons.back().first >= sep.lit) {
+            ca.free(xor_reasons.back().second);
+            xor_reasons.pop_back();
+        }
+
         qhead = trail_lim[level].lit;
         trail.shrink(trail.size() - sep.lit);
         trail_leq_stat.shrink(trail_leq_stat.size() - sep.leq);
@@ -819,6 +1374,7 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel) {
 
     int pathC = 0;
     Lit p = lit_Undef;
+    analyze_taint = false;
 
     // Generate conflict clause:
     //
@@ -829,6 +1385,11 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel) {
         // add ~q as a visited antecident (in the graph it is ~q, and q is added
         // to the learnt clause)
 
+        if (track_taint && level(var(q)) == 0) {
+            // root level lits are dropped, but the learnt depends on them
+            analyze_taint |= root_taint[var(q)];
+        }
+
         if (!seen[var(q)] && level(var(q)) > 0) {
             varBumpActivity(var(q));
             seen[var(q)] = 1;
@@ -846,6 +1407,7 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel) {
     do {
         assert(confl != CRef_Undef);  // (otherwise should be UIP)
         Clause& c = ca[confl];
+        analyze_taint |= c.tainted();
 
         if (c.is_leq()) {
             // note: this code is duplicated in litRedundant
@@ -909,6 +1471,10 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel) {
                     throw std::runtime_error{
                             "ccmin=1 for LEQ clause unimplemented"};
                 }
+                if (track_taint) {
+                    // conservative: the lit might be removed
+                    analyze_taint |= root_reason_taint(c);
+                }
                 for (int k = 1; k < c.size(); k++)
                     if (!seen[var(c[k])] && level(var(c[k])) > 0) {
                         out_learnt[j++] = out_learnt[i];
@@ -955,6 +1521,10 @@ bool Solver::litRedundant(Lit p, abstract_level_set_t abstract_levels) {
     auto add_antecedent =
             [ this, top = analyze_toclear.size(), abstract_levels ](Lit p)
                     __attribute__((always_inline)) {
+        if (track_taint && level(var(p)) == 0) {
+            // conservative since p might turn out to be not redundant
+            analyze_taint |= root_taint[var(p)];
+        }
         if (!seen[var(p)] && level(var(p)) > 0) {
             if (reason(var(p)) != CRef_Undef &&
                 (abstractLevel(var(p)) & abstract_levels) != 0) {
@@ -974,6 +1544,7 @@ bool Solver::litRedundant(Lit p, abstract_level_set_t abstract_levels) {
         assert(reason(var(analyze_stack.last())) != CRef_Undef);
         Clause& c = ca[reason(var(analyze_stack.last()))];
         analyze_stack.pop();
+        analyze_taint |= c.tainted();
 
         if (c.is_leq()) {
             LeqStatus status = c.leq_status();
@@ -1033,12 +1604,23 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict) {
             } else {
                 Clause& c = ca[reason(x)];
                 if (c.is_leq()) {
-                    throw std::runtime_error(
-                            "assumptions with LEQ clause not implmented");
+                    // see analyze() for the antecedents of LEQ clauses
+                    LeqStatus status = c.leq_status();
+                    assert(status.imply_type);
+                    int is_true = status.precond_is_true,
+                        size = is_true ? status.nr_true
+                                       : status.nr_decided - status.nr_true;
+                    for (int j = 0; j < size; j++)
+                        if (level(var(c[j])) > 0)
+                            seen[var(c[j])] = 1;
+                    if (status.imply_type != LeqStatus::IMPLY_DST &&
+                        level(var(c.leq_dst())) > 0)
+                        seen[var(c.leq_dst())] = 1;
+                } else {
+                    for (int j = 1; j < c.size(); j++)
+                        if (level(var(c[j])) > 0)
+                            seen[var(c[j])] = 1;
                 }
-                for (int j = 1; j < c.size(); j++)
-                    if (level(var(c[j])) > 0)
-                        seen[var(c[j])] = 1;
             }
             seen[x] = 0;
         }
@@ -1047,8 +1629,12 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict) {
     seen[var(p)] = 0;
 }
 
-void Solver::uncheckedEnqueue(Lit p, CRef from) {
+void Solver::uncheckedEnqueue(Lit p, CRef from, bool taint) {
     assert(value(p) == l_Undef);
+    if (track_taint && decisionLevel() == 0) {
+        root_taint[var(p)] =
+                from == CRef_Undef ? taint : root_reason_taint(ca[from]);
+    }
     assigns[var(p)] = lbool(!sign(p));
     vardata[var(p)] = VarData{from, decisionLevel()};
     trail.push_(p);
@@ -1140,6 +1726,12 @@ CRef Solver::propagate() {
         if (confl == CRef_Undef) {
             confl = propagate_leq(p);
         }
+        if (confl == CRef_Undef && !xor_matrices.empty()) {
+            confl = propagate_xor(p);
+            if (confl != CRef_Undef) {
+                qhead = trail.size();
+            }
+        }
     }
     propagations += num_props;
     simpDB_props -= num_props;
@@ -1368,11 +1960,13 @@ void Solver::reduceDB() {
 
     sort(learnts, reduceDB_lt(ca));
     // Don't delete binary or locked clauses. From the rest, delete clauses from
-    // the first half and clauses with activity smaller than 'extra_lim':
+    // the first half (three quarters under memory pressure) and clauses with
+    // activity smaller than 'extra_lim':
+    int nr_del = mem_pressure ? learnts.size() / 4 * 3 : learnts.size() / 2;
     for (i = j = 0; i < learnts.size(); i++) {
         Clause& c = ca[learnts[i]];
         if (c.size() > 2 && !locked_disj(c) &&
-            (i < learnts.size() / 2 || c.activity() < extra_lim))
+            (i < nr_del || c.activity() < extra_lim))
             removeClause(learnts[i]);
         else
             learnts[j++] = learnts[i];
@@ -1382,10 +1976,35 @@ void Solver::reduceDB() {
 }
 
 void Solver::removeSatisfied(vec<CRef>& cs) {
+    // Scan the disjunctive clauses over helper threads first. LEQs may be
+    // rewritten by try_leq_simplify(), which adds clauses, so they are
+    // checked in order below; a clause found unsatisfied is checked again if
+    // the units added meanwhile have extended the trail. Clauses appended to
+    // @p cs during the loop are not scanned and are always checked.
+    enum : uint8_t { KEEP, SAT, CHECK };
+    const int nr_scanned = cs.size();
+    std::vector<uint8_t> state(nr_scanned);
+    int trail_size = trail.size();
+    gc_parallel_for(nr_scanned, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Clause& c = ca[cs[i]];
+            state[i] = c.is_leq() ? CHECK : satisfied(c) ? SAT : KEEP;
+        }
+    });
+
     int i, j;
     for (i = j = 0; i < cs.size(); i++) {
         Clause& c = ca[cs[i]];
-        if (satisfied(c) || try_leq_simplify(c)) {
+        bool remove;
+        uint8_t st = i < nr_scanned ? state[i] : uint8_t{CHECK};
+        if (st == SAT) {
+            remove = true;
+        } else if (st == KEEP && trail.size() == trail_size) {
+            remove = false;
+        } else {
+            remove = satisfied(c) || try_leq_simplify(c);
+        }
+        if (remove) {
             removeClause(cs[i]);
         } else {
             cs[j++] = cs[i];
@@ -1399,7 +2018,24 @@ void Solver::rebuildOrderHeap() {
     for (Var v = 0; v < nVars(); v++)
         if (decision[v] && value(v) == l_Undef)
             vs.push(v);
-    order_heap.build(vs);
+    order_heap.build(vs, [this](size_t n, auto&& fn) {
+        gc_parallel_for(n, fn);
+    });
+    heap_clean_assigns = trail.size();
+}
+
+void Solver::cleanOrderHeap() {
+    assert(decisionLevel() == 0);
+    // vars assigned at level 0 would be skipped by pickBranchLit() anyway, so
+    // only the newly fixed ones need to be removed
+    for (int i = std::min(heap_clean_assigns, trail.size()); i < trail.size();
+         i++) {
+        Var v = var(trail[i]);
+        if (order_heap.inHeap(v)) {
+            order_heap.remove(v);
+        }
+    }
+    heap_clean_assigns = trail.size();
 }
 
 /*_________________________________________________________________________________________________
@@ -1412,37 +2048,75 @@ Currently, the only |    thing done here is the removal of satisfied clauses,
 but more things can be put here.
 |________________________________________________________________________________________________@*/
 bool Solver::simplify() {
-    assert(decisionLevel() == 0);
+    // drop the levels kept by reuse_trail, if any
+    cancelUntil(0);
 
     if (!ok || propagate() != CRef_Undef)
         return ok = false;
 
+    if (xor_detect && !xors_detected) {
+        xors_detected = true;
+        detect_xors();
+    }
+    if (xors_dirty && (!gauss_setup() || propagate() != CRef_Undef)) {
+        return ok = false;
+    }
+    if (leq_pairs && !leq_pairs_derived) {
+        leq_pairs_derived = true;
+        if (!derive_leq_pairs()) {
+            return ok = false;
+        }
+    }
+    if (symmetry && !symmetry_broken && !incremental && !assumptions.size()) {
+        symmetry_broken = true;
+        if (!break_symmetries()) {
+            return ok = false;
+        }
+    }
+    if (lp_phase && !lp_guided) {
+        lp_guided = true;
+        lp_guide();
+    }
+    if (td_order && !td_ordered) {
+        td_ordered = true;
+        tree_decomp_order();
+    }
+
     if (nAssigns() == simpDB_assigns || (simpDB_props > 0))
         return true;
 
     // Remove satisfied clauses:
     removeSatisfied(learnts);
 
-    if (remove_satisfied && propagations >= next_remove_satisfied_nr_prop) {
-        removeSatisfied(clauses);
+    if (remove_satisfied) {
+        bool changed = false;
+        if (inproc_satisfied.due(propagations)) {
+            int64_t lits = clauses_literals;
+            removeSatisfied(clauses);
+            inproc_satisfied.update(propagations, lits,
+                                    lits - int64_t(clauses_literals),
+                                    inproc_effort);
+            changed = true;
+        }
 
-        if (!next_remove_satisfied_nr_prop) {
-            // only remove dead vars at the beginning
+        // dead vars might be fixed against assumptions
+        if (!incremental && !assumptions.size() &&
+            inproc_dead_vars.due(propagations)) {
+            int64_t lits = clauses_literals + learnts_literals;
             dead_var_remover.simplify();
+            inproc_dead_vars.update(
+                    propagations, lits,
+                    lits - int64_t(clauses_literals + learnts_literals),
+                    inproc_effort);
+            changed = true;
         }
 
-        // we will never need to backtrace below 0, so it's safe to clear the
-        // stats; this is also necessary because their pointers to stat would
-        // become dangling after garbage collection
-        trail_leq_stat.clear();
-
-        // remove watchers on removed clauses
-        leq_watches.cleanAll();
-
-        next_remove_satisfied_nr_prop = propagations + 300000;
+        if (changed) {
+            cleanLeqWatches();
+        }
     }
     checkGarbage();
-    rebuildOrderHeap();
+    cleanOrderHeap();
 
     simpDB_assigns = nAssigns();
     simpDB_props = clauses_literals +
@@ -1452,6 +2126,37 @@ bool Solver::simplify() {
     return true;
 }
 
+void Solver::cleanLeqWatches() {
+    assert(decisionLevel() == 0);
+    // we will never need to backtrace below 0, so it's safe to clear the
+    // stats; this is also necessary because their pointers to stat would
+    // become dangling after garbage collection
+    trail_leq_stat.clear();
+
+    // remove watchers on removed clauses
+    leq_watches.cleanAll(
+            [this](size_t n, auto&& fn) { gc_parallel_for(n, fn); });
+}
+
+void Solver::InprocPass::update(uint64_t propagations, uint64_t cost,
+                                int64_t gain, double effort) {
+    constexpr uint64_t MIN_INTERVAL = 10000, MAX_INTERVAL = uint64_t(1) << 40;
+    nr_run++;
+    tot_cost += cost;
+    tot_gain += std::max<int64_t>(gain, 0);
+
+    // a pass pays off if it removes a noticeable part of what it scans
+    if (gain > 0 && uint64_t(gain) * 64 >= cost) {
+        interval = std::max(interval / 2, MIN_INTERVAL);
+    } else {
+        interval = std::min(interval * 2, MAX_INTERVAL);
+    }
+    if (effort > 0) {
+        interval = std::max(interval, uint64_t(cost / effort));
+    }
+    next_run = propagations + interval;
+}
+
 bool Solver::try_leq_simplify(Clause& c) {
     if (!c.is_leq()) {
         return false;
@@ -1463,6 +2168,9 @@ bool Solver::try_leq_simplify(Clause& c) {
 
     assert(0 <= bound && bound < size);
 
+    // the simplified constraint depends on the root values of decided lits
+    bool taint = stat.nr_decided && track_taint && root_reason_taint(c);
+
     if (stat.nr_decided) {
         // shrink to keep only undecided lits
         int wr = 0;
@@ -1476,12 +2184,14 @@ bool Solver::try_leq_simplify(Clause& c) {
 
     if (bound == 0) {
         // equivalent to dst = ~(p0 | p1 | ...)
-        addClauseReifiedConjunction<true>(c.leq_dst(), c.lit_data(), size);
+        addClauseReifiedConjunction<true>(c.leq_dst(), c.lit_data(), size,
+                                          taint);
         return true;
     }
     if (bound == size - 1) {
         // equivalent to dst = ~(p0 & p1 & ...)
-        addClauseReifiedConjunction<false>(~c.leq_dst(), c.lit_data(), size);
+        addClauseReifiedConjunction<false>(~c.leq_dst(), c.lit_data(), size,
+                                           taint);
         return true;
     }
 
@@ -1494,6 +2204,7 @@ bool Solver::try_leq_simplify(Clause& c) {
         leq_watches.smudge(var(c.leq_dst()));
         stat.nr_decided = stat.nr_true = 0;
         c.shrink_leq_to(size, bound);
+        c.tainted(taint);
     }
 
     return false;
@@ -1516,7 +2227,9 @@ unsatisfiable. 'l_Undef' if the bound on number of conflicts is reached.
 lbool Solver::search(int nof_conflicts) {
     assert(ok);
     int backtrack_level;
-    int conflictC = 0;
+    // continue the restart interval stopped by the budget, if any
+    int conflictC = restart_conflicts;
+    restart_conflicts = 0;
     vec<Lit> learnt_clause;
     starts++;
 
@@ -1531,12 +2244,17 @@ lbool Solver::search(int nof_conflicts) {
 
             learnt_clause.clear();
             analyze(confl, learnt_clause, backtrack_level);
+            if (!analyze_taint && should_export_learnt(learnt_clause)) {
+                base_learnts.emplace_back();
+                learnt_clause.copyTo(base_learnts.back());
+            }
             cancelUntil(backtrack_level);
 
             if (learnt_clause.size() == 1) {
-                uncheckedEnqueue(learnt_clause[0]);
+                uncheckedEnqueue(learnt_clause[0], CRef_Undef, analyze_taint);
             } else {
                 CRef cr = ca.alloc(learnt_clause, true);
+                ca[cr].tainted(analyze_taint);
                 learnts.push(cr);
                 attachClause(cr);
                 claBumpActivity(ca[cr]);
@@ -1568,7 +2286,13 @@ lbool Solver::search(int nof_conflicts) {
                 !withinBudget()) {
                 // Reached bound on number of conflicts:
                 progress_estimate = progressEstimate();
-                cancelUntil(0);
+                if (withinBudget()) {
+                    // restart; when the budget is exhausted, solve_() decides
+                    // which levels to keep
+                    cancelUntil(0);
+                } else {
+                    restart_conflicts = conflictC;
+                }
                 return l_Undef;
             }
 
@@ -1580,6 +2304,9 @@ lbool Solver::search(int nof_conflicts) {
                 // Reduce the set of learnt clauses:
                 reduceDB();
 
+            if (mem_target && conflicts >= next_mem_check)
+                check_memory();
+
             Lit next = lit_Undef;
             while (decisionLevel() < assumptions.size()) {
                 // Perform user provided assumption:
@@ -1598,9 +2325,19 @@ lbool Solver::search(int nof_conflicts) {
 
             if (next == lit_Undef) {
                 // New variable decision:
-                next = pickBranchLit();
+                if (!partial_model || !all_constraints_satisfied()) {
+                    next = pickBranchLit();
+                }
                 if (next == lit_Undef) {
-                    // Model found:
+                    // Model found, unless refined by a derived class:
+                    uint64_t prev_added = added_constraints;
+                    on_model_candidate();
+                    if (!ok) {
+                        return l_False;
+                    }
+                    if (added_constraints != prev_added) {
+                        continue;
+                    }
                     return l_True;
                 }
 
@@ -1614,6 +2351,54 @@ lbool Solver::search(int nof_conflicts) {
     }
 }
 
+bool Solver::all_constraints_satisfied() {
+    int level = decisionLevel();
+    while (!sat_scan.empty() && sat_scan.back().first > level) {
+        sat_scan.pop_back();
+    }
+    int pos = sat_scan.empty() ? 0 : sat_scan.back().second;
+    for (; pos < clauses.size(); ++pos) {
+        const Clause& c = ca[clauses[pos]];
+        bool sat = false;
+        if (!c.is_leq()) {
+            for (int i = 0; i < c.size() && !sat; ++i) {
+                sat = value(c[i]) == l_True;
+            }
+        } else if (lbool dst = value(c.leq_dst()); dst.is_not_undef()) {
+            // dst is true when at most bound lits can still be true, and
+            // false when more than bound lits are already true
+            bool want = dst == l_False;
+            int cnt = 0;
+            for (int i = 0; i < c.size(); ++i) {
+                cnt += value(c[i]).is_boolv(want);
+            }
+            sat = dst == l_True ? c.size() - cnt <= c.leq_bound()
+                                : cnt > c.leq_bound();
+        }
+        if (!sat) {
+            break;
+        }
+    }
+    bool done = pos == clauses.size();
+    for (size_t i = 0; i < xors.size() && done; ++i) {
+        bool parity = xors[i].rhs;
+        for (Var v : xors[i].vars) {
+            done &= value(v) != l_Undef;
+            parity ^= value(v) == l_True;
+        }
+        done &= !parity;
+    }
+    // level 0 is not recorded since clauses may change there
+    if (level) {
+        if (!sat_scan.empty() && sat_scan.back().first == level) {
+            sat_scan.back().second = pos;
+        } else {
+            sat_scan.emplace_back(level, pos);
+        }
+    }
+    return done;
+}
+
 double Solver::progressEstimate() const {
     double progress = 0;
     double F = 1.0 / nVars();
@@ -1655,13 +2440,95 @@ static double luby(double y, int x) {
     return pow(y, seq);
 }
 
+lbool Solver::lookup_result_cache() {
+    if (added_constraints != cache_added_constraints) {
+        // cores remain valid since constraints are only added
+        result_cache.invalidate_models();
+        cache_added_constraints = added_constraints;
+    }
+    if (auto core = result_cache.find_core(assumptions)) {
+        for (Lit p : *core) {
+            conflict.push(~p);
+        }
+        strip_scope_conflict();
+        return l_False;
+    }
+    if (auto m = result_cache.find_model(assumptions)) {
+        m->copyTo(model);
+        // vars added since the model was stored are unconstrained
+        model.growTo(nVars(), l_False);
+        return l_True;
+    }
+    return l_Undef;
+}
+
+void Solver::strip_scope_conflict() {
+    if (!scopes.size()) {
+        return;
+    }
+    // the final conflict is expressed in user assumptions only
+    int i, j;
+    for (i = j = 0; i < conflict.size(); i++) {
+        if (!is_scope_var[var(conflict[i])]) {
+            conflict[j++] = conflict[i];
+        }
+    }
+    conflict.shrink(i - j);
+}
+
 // NOTE: assumptions passed in member-variable 'assumptions'.
 lbool Solver::solve_() {
     model.clear();
     conflict.clear();
+    sat_scan.clear();
     if (!ok)
         return l_False;
 
+    if (scopes.size()) {
+        // selectors of open scopes are assumed before user assumptions
+        int nr_user = assumptions.size(), nr_sel = scopes.size();
+        assumptions.growTo(nr_user + nr_sel);
+        for (int i = nr_user - 1; i >= 0; i--) {
+            assumptions[i + nr_sel] = assumptions[i];
+        }
+        for (int i = 0; i < nr_sel; i++) {
+            assumptions[i] = mkLit(scopes[i].selector);
+        }
+    }
+
+    if (result_cache.enabled()) {
+        lbool cached = lookup_result_cache();
+        if (cached.is_not_undef()) {
+            cache_hits++;
+            return cached;
+        }
+    }
+
+    {
+        // reuse the levels of the common assumption prefix kept by the last
+        // call; any level above it is discarded, unless the last call was
+        // stopped by its budget and this one resumes it
+        int nr_keep = 0;
+        while (nr_keep < decisionLevel() && nr_keep < assumptions.size() &&
+               nr_keep < kept_assumptions.size() &&
+               kept_assumptions[nr_keep] == assumptions[nr_keep]) {
+            nr_keep++;
+        }
+        if (search_kept && nr_keep == assumptions.size() &&
+            nr_keep == kept_assumptions.size()) {
+            nr_keep = decisionLevel();
+        } else {
+            restart_conflicts = 0;
+        }
+        search_kept = false;
+        cancelUntil(nr_keep);
+    }
+
+    bool sliced = slice && assumptions.size();
+    if (sliced) {
+        slice_query();
+    }
+
     double cpu_time_begin = 0;
     if (verbosity > 0) {
         cpu_time_begin = cpuTime();
@@ -1680,10 +2547,16 @@ lbool Solver::solve_() {
         printf("|  Number of var pref:   %12d                                  "
                "       |\n",
                nr_pref);
+        if (sliced) {
+            printf("|  Sliced: %12d gates, %12d vars                           "
+                   "   |\n",
+                   int(slice_gates.size()), slice_vars.size());
+        }
     }
 
-    // first try simplify() for unit propagation
-    {
+    // first try simplify() for unit propagation; skipped if assumption levels
+    // have been kept, since the trail is already propagated
+    if (decisionLevel() == 0) {
         bool simplify_result = simplify();
         if (verbosity > 0) {
             printf("|  Simplified: (result=%d)%12d/%-12d                     "
@@ -1701,17 +2574,31 @@ lbool Solver::solve_() {
             printf("|  Max LEQ bound:        %12d                              "
                    "           |\n",
                    max_leq_bound);
+            if (!xor_matrices.empty()) {
+                printf("|  XOR matrices: %12d (%12d rows)                      "
+                       "       |\n",
+                       int(xor_matrices.size()), int(xors.size()));
+            }
         }
         if (!simplify_result) {
+            if (sliced) {
+                unslice_query();
+            }
             return l_False;
         }
     }
 
     solves++;
 
-    max_learnts = nClauses() * learntsize_factor;
-    learntsize_adjust_confl = learntsize_adjust_start_confl;
-    learntsize_adjust_cnt = (int)learntsize_adjust_confl;
+    // with reuse_trail, the learnt limit keeps growing across calls like the
+    // restart sequence, so that a solve split into slices (see
+    // SolveScheduler) does not start over with a small learnt database
+    if (!reuse_trail || !learnt_limit_started) {
+        max_learnts = nClauses() * learntsize_factor;
+        learntsize_adjust_confl = learntsize_adjust_start_confl;
+        learntsize_adjust_cnt = (int)learntsize_adjust_confl;
+        learnt_limit_started = true;
+    }
     lbool status = l_Undef;
 
     if (verbosity >= 1) {
@@ -1726,7 +2613,10 @@ lbool Solver::solve_() {
     }
 
     // Search:
-    int curr_restarts = 0;
+    if (!reuse_trail) {
+        curr_restarts = 0;
+        restart_conflicts = 0;
+    }
     while (status == l_Undef) {
         double rest_base = luby_restart ? luby(restart_inc, curr_restarts)
                                         : pow(restart_inc, curr_restarts);
@@ -1734,6 +2624,9 @@ lbool Solver::solve_() {
         if (!withinBudget())
             break;
         curr_restarts++;
+        if (status == l_Undef && bg_simp && !bg_simp_exchange()) {
+            status = l_False;
+        }
     }
 
     if (verbosity >= 1) {
@@ -1752,6 +2645,38 @@ lbool Solver::solve_() {
         printf("conflict literals     : %-12" PRIu64 "   (%4.2f %% deleted)\n",
                tot_literals,
                (max_literals - tot_literals) * 100 / (double)max_literals);
+        printf("inprocessing          : %" PRIu64 " / %" PRIu64
+               " runs   (%" PRIu64 " / %" PRIu64 " lits removed)\n",
+               inproc_satisfied.nr_run, inproc_dead_vars.nr_run,
+               inproc_satisfied.tot_gain, inproc_dead_vars.tot_gain);
+        if (!xor_matrices.empty()) {
+            printf("xor propagations      : %-12" PRIu64 "   (%" PRIu64
+                   " conflicts, %" PRIu64 " pivots)\n",
+                   xor_propagations, xor_conflicts, xor_pivots);
+        }
+        if (leq_pairs_derived) {
+            printf("leq pair relations    : %-12" PRIu64 "   (%" PRIu64
+                   " units)\n",
+                   leq_pair_binaries, leq_pair_units);
+        }
+        if (symmetry_broken) {
+            printf("symmetry generators   : %-12" PRIu64 "   (%" PRIu64
+                   " clauses)\n",
+                   sym_generators, sym_clauses);
+        }
+        if (bg_simp_rounds) {
+            printf("background simp       : %-12" PRIu64 "   (%" PRIu64
+                   " units, %" PRIu64 " strengthened, %" PRIu64
+                   " deleted)\n",
+                   bg_simp_rounds, bg_simp_units, bg_simp_strengthened,
+                   bg_simp_deleted);
+        }
+        if (mem_reductions) {
+            printf("memory reductions     : %-12" PRIu64 "   (%s)\n",
+                   mem_reductions,
+                   mem_over_target ? "target exceeded by irreducible data"
+                                   : "within target");
+        }
     }
 
     if (status == l_True) {
@@ -1761,118 +2686,315 @@ lbool Solver::solve_() {
         for (int i = 0; i < nVars(); i++) {
             model[i] = value(i);
         }
+        if (sliced) {
+            extend_sliced_model();
+        }
+        for (auto [v, p] : substituted_vars) {
+            model[v] = model[var(p)] ^ sign(p);
+        }
+        if (reuse_trail) {
+            // the last model is the phase hint for the next query
+            for (int i = 0; i < nVars(); i++) {
+                if (model[i] != l_Undef) {
+                    polarity[i] = model[i] == l_False;
+                }
+            }
+        }
     } else if (status == l_False && conflict.size() == 0)
         ok = false;
 
-    cancelUntil(0);
+    if (result_cache.enabled()) {
+        if (status == l_True) {
+            result_cache.add_model(model);
+        } else if (status == l_False && conflict.size()) {
+            // the core consists of the negated lits of the final conflict
+            vec<Lit> core;
+            for (Lit p : conflict) {
+                core.push(~p);
+            }
+            result_cache.add_core(core);
+        }
+    }
+
+    if (status == l_False) {
+        strip_scope_conflict();
+    }
+
+    kept_assumptions.clear();
+    if (reuse_trail) {
+        int nr_keep = std::min(decisionLevel(), assumptions.size());
+        // a search stopped by its budget keeps all its levels, so that a
+        // solve split into slices does not restart at each slice
+        search_kept = status == l_Undef && decisionLevel() > nr_keep;
+        if (!search_kept) {
+            cancelUntil(nr_keep);
+        }
+        for (int i = 0; i < nr_keep; i++) {
+            kept_assumptions.push(assumptions[i]);
+        }
+    } else {
+        cancelUntil(0);
+    }
+    if (sliced) {
+        unslice_query();
+    }
     return status;
 }
 
+void Solver::complete_model() {
+    for (int i = 0; i < model.size(); i++) {
+        if (model[i] == l_Undef) {
+            model[i] = l_False;
+        }
+    }
+    for (auto [v, p] : substituted_vars) {
+        model[v] = model[var(p)] ^ sign(p);
+    }
+}
+
 //=================================================================================================
 // Writing CNF to DIMACS:
-//
-// FIXME: this needs to be rewritten completely.
 
-static Var mapVar(Var x, vec<Var>& map, Var& max) {
-    if (map.size() <= x || map[x] == -1) {
-        map.growTo(x + 1, -1);
-        map[x] = max++;
-    }
-    return map[x];
+void Solver::toDimacs(const char* file, const vec<Lit>& assumps) {
+    if (!export_dimacs(file, assumps))
+        fprintf(stderr, "could not write file %s\n", file), exit(1);
 }
 
-void Solver::toDimacs(FILE* f, Clause& c, vec<Var>& map, Var& max) {
-    if (satisfied(c))
-        return;
-
-    for (int i = 0; i < c.size(); i++)
-        if (value(c[i]) != l_False)
-            fprintf(f, "%s%d ", sign(c[i]) ? "-" : "",
-                    mapVar(var(c[i]), map, max) + 1);
-    fprintf(f, "0\n");
+void Solver::toDimacs(FILE* f, const vec<Lit>& assumps) {
+    std::unique_ptr<OutputBuffer> out{new OutputBuffer{f}};
+    export_dimacs(*out, assumps, false);
 }
 
-void Solver::toDimacs(const char* file, const vec<Lit>& assumps) {
-    FILE* f = fopen(file, "wr");
-    if (f == NULL)
-        fprintf(stderr, "could not open file %s\n", file), exit(1);
-    toDimacs(f, assumps);
-    fclose(f);
+bool Solver::export_dimacs(const char* file, const vec<Lit>& assumps,
+                           bool with_learnts) {
+    size_t len = strlen(file);
+    if (len >= 3 && !strcmp(file + len - 3, ".gz")) {
+        gzFile f = gzopen(file, "wb6");
+        if (!f) {
+            return false;
+        }
+        std::unique_ptr<OutputBuffer> out{new OutputBuffer{f}};
+        export_dimacs(*out, assumps, with_learnts);
+        bool succ = out->flush();
+        return gzclose(f) == Z_OK && succ;
+    }
+    FILE* f = fopen(file, "w");
+    if (!f) {
+        return false;
+    }
+    std::unique_ptr<OutputBuffer> out{new OutputBuffer{f}};
+    export_dimacs(*out, assumps, with_learnts);
+    bool succ = out->flush();
+    return !fclose(f) && succ;
 }
 
-void Solver::toDimacs(FILE* f, const vec<Lit>& /*assumps*/) {
+void Solver::export_dimacs(OutputBuffer& out, const vec<Lit>& assumps,
+                           bool with_learnts) {
     // Handle case when solver is in contradictory state:
     if (!ok) {
-        fprintf(f, "p cnf 1 2\n1 0\n-1 0\n");
+        out.put("p cnf 1 2\n1 0\n-1 0\n");
         return;
     }
 
-    vec<Var> map;
-    Var max = 0;
+    vec<char> used;
+    int cnt = export_dimacs_body(nullptr, assumps, with_learnts, used);
+    int max = used.size();
+    while (max && !used[max - 1]) {
+        --max;
+    }
+    out.put("p cnf ");
+    out.put_int(max);
+    out.put(' ');
+    out.put_int(cnt);
+    out.put('\n');
+    export_dimacs_body(&out, assumps, with_learnts, used);
 
-    // Cannot use removeClauses here because it is not safe
-    // to deallocate them at this point. Could be improved.
+    if (verbosity > 0)
+        printf("Wrote %d clauses with %d variables.\n", cnt, max);
+}
+
+int Solver::export_dimacs_body(OutputBuffer* out, const vec<Lit>& assumps,
+                               bool with_learnts, vec<char>& used) {
+    for (const XorConstraint& x : xors) {
+        minisat_uassert(x.from_clauses,
+                        "XOR constraints can not be exported to DIMACS");
+    }
+    used.clear();
+    used.growTo(nVars(), 0);
     int cnt = 0;
-    for (int i = 0; i < clauses.size(); i++)
-        if (!satisfied(ca[clauses[i]]))
-            cnt++;
 
-    for (int i = 0; i < clauses.size(); i++)
-        if (!satisfied(ca[clauses[i]])) {
-            Clause& c = ca[clauses[i]];
-            for (int j = 0; j < c.size(); j++)
-                if (value(c[j]) != l_False)
-                    mapVar(var(c[j]), map, max);
+    auto put_lit = [out, &used](Lit p) {
+        used[var(p)] = 1;
+        if (out) {
+            out->put_int(sign(p) ? -var(p) - 1 : var(p) + 1);
+            out->put(' ');
         }
+    };
+    auto put_unit = [out, &cnt, &put_lit](Lit p) {
+        ++cnt;
+        put_lit(p);
+        if (out) {
+            out->put("0\n");
+        }
+    };
 
-    // Assumptions are added as unit clauses:
-    cnt += assumptions.size();
-
-    fprintf(f, "p cnf %d %d\n", max, cnt);
-
-    for (int i = 0; i < assumptions.size(); i++) {
-        assert(value(assumptions[i]) != l_False);
-        fprintf(f, "%s%d 0\n", sign(assumptions[i]) ? "-" : "",
-                mapVar(var(assumptions[i]), map, max) + 1);
+    int root_end = trail_lim.size() ? trail_lim[0].lit : trail.size();
+    for (int i = 0; i < root_end; ++i) {
+        put_unit(trail[i]);
+    }
+    for (const Scope& i : scopes) {
+        put_unit(mkLit(i.selector));
+    }
+    for (Lit i : assumps) {
+        put_unit(i);
     }
 
-    for (int i = 0; i < clauses.size(); i++)
-        toDimacs(f, ca[clauses[i]], map, max);
+    auto put_clause = [&](const Clause& c) {
+        if (c.mark()) {
+            return;
+        }
+        if (c.is_leq()) {
+            int bound = c.leq_bound(), nr_undef = 0;
+            for (int i = 0; i < c.size(); ++i) {
+                lbool v = rootValue(c[i]);
+                if (v == l_True) {
+                    --bound;
+                } else if (v == l_Undef) {
+                    ++nr_undef;
+                }
+            }
+            Lit dst = c.leq_dst();
+            if (bound < 0 || bound >= nr_undef) {
+                // value of the LEQ is fixed at root level
+                if (bound < 0) {
+                    dst = ~dst;
+                }
+                if (rootValue(dst) != l_True) {
+                    put_unit(dst);
+                }
+                return;
+            }
+            ++cnt;
+            for (int i = 0; i < c.size(); ++i) {
+                if (rootValue(c[i]) == l_Undef) {
+                    put_lit(c[i]);
+                }
+            }
+            if (out) {
+                out->put("<= ");
+                out->put_int(bound);
+                out->put(" # ");
+            }
+            used[var(dst)] = 1;
+            if (out) {
+                out->put_int(sign(dst) ? -var(dst) - 1 : var(dst) + 1);
+                out->put('\n');
+            }
+            return;
+        }
+        for (int i = 0; i < c.size(); ++i) {
+            if (rootValue(c[i]) == l_True) {
+                return;
+            }
+        }
+        ++cnt;
+        for (int i = 0; i < c.size(); ++i) {
+            if (rootValue(c[i]) != l_False) {
+                put_lit(c[i]);
+            }
+        }
+        if (out) {
+            out->put("0\n");
+        }
+    };
+    for (CRef i : clauses) {
+        put_clause(ca[i]);
+    }
+    if (with_learnts) {
+        for (CRef i : learnts) {
+            put_clause(ca[i]);
+        }
+    }
 
-    if (verbosity > 0)
-        printf("Wrote %d clauses with %d variables.\n", cnt, max);
+    // preferences are only written for vars that occur in the problem, since
+    // the parser creates vars on demand
+    if (out) {
+        int nr_pref = 0;
+        for (Var i = 0; i < used.size(); ++i) {
+            if (!used[i] || !var_preference[i]) {
+                continue;
+            }
+            if (!nr_pref) {
+                out->put("c vpref");
+            }
+            out->put(' ');
+            out->put_int(i + 1);
+            out->put(' ');
+            out->put_int(var_preference[i]);
+            if (++nr_pref == 16) {
+                out->put(" 0\n");
+                nr_pref = 0;
+            }
+        }
+        if (nr_pref) {
+            out->put(" 0\n");
+        }
+    }
+    return cnt;
 }
 
 //=================================================================================================
 // Garbage Collection methods:
 
 void Solver::relocAll(ClauseAllocator& to) {
+    auto par_for = [this](size_t n, auto&& fn) { gc_parallel_for(n, fn); };
+
     // Remove watchers for deleted clauses
-    watches.cleanAll();
-    leq_watches.cleanAll();
+    watches.cleanAll(par_for);
+    leq_watches.cleanAll(par_for);
+
+    if (gc_threads) {
+        reloc_in_list_order(to);
+    } else {
+        reloc_in_watch_order(to);
+    }
+
+    // All refs to clause status in LeqStatusModLog entries:
+    //
+    gc_parallel_for(trail_leq_stat.size(), [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j) {
+            LeqStatusModLog& i = trail_leq_stat[j];
+            Clause& cnew = to[i.status(ca).get_cref_after_reloc()];
+            assert(cnew.is_leq() && i.status(ca) == cnew.leq_status());
+            i.status_ref = to.ael(&cnew.leq_status());
+        }
+    });
 
+    // Learnts of the background snapshot; removed ones are not relocated
+    for (CRef& cr : bg_simp_learnts) {
+        if (cr != CRef_Undef) {
+            if (ca[cr].reloced()) {
+                ca.reloc_done(cr);
+            } else {
+                cr = CRef_Undef;
+            }
+        }
+    }
+}
+
+void Solver::reloc_in_watch_order(ClauseAllocator& to) {
     // All original:
     // note that we move original clauses first so LEQ clauses would be placed
     // near the beginning
     for (CRef& i : clauses)
         ca.reloc(i, to);
 
-    // All refs to clause status in LeqStatusModLog entries:
-    //
-    for (LeqStatusModLog& i : trail_leq_stat) {
-        Clause& cnew = to[i.status(ca).get_cref_after_reloc()];
-        assert(i.status(ca) == cnew.leq_status());
-        assert(cnew.is_leq() && i.status(ca) == cnew.leq_status());
-        i.status_ref = to.ael(&cnew.leq_status());
-    }
-
-    // All watcher refs:
-    //
+    // Learnts in the order their watchers are met, so that the learnts
+    // watched by a lit stay close; this also copies clauses that are only
+    // referenced by watchers
     for (int v = 0; v < nVars(); v++) {
         for (int s = 0; s < 2; s++) {
-            Lit p = mkLit(v, s);
-            // printf(" >>> RELOCING: %s%d\n", sign(p)?"-":"", var(p)+1);
-            for (Watcher& w : watches[p]) {
+            for (Watcher& w : watches[mkLit(v, s)]) {
                 ca.reloc(w.cref, to);
             }
         }
@@ -1884,19 +3006,129 @@ void Solver::relocAll(ClauseAllocator& to) {
     // All reasons:
     // note: reasons only meaningful for vars in the trail
     for (int i = 0; i < trail.size(); i++) {
-        Var v = var(trail[i]);
-
-        if (CRef& r = vardata[v].reason; r != CRef_Undef) {
+        if (CRef& r = vardata[var(trail[i])].reason; r != CRef_Undef) {
             ca.reloc(r, to);
         }
     }
 
+    for (auto& i : xor_reasons) {
+        ca.reloc(i.second, to);
+    }
+
     // All learnt:
     //
     for (int i = 0; i < learnts.size(); i++)
         ca.reloc(learnts[i], to);
 }
 
+void Solver::reloc_in_list_order(ClauseAllocator& to) {
+    // All original and learnt:
+    // the new locations are assigned by a prefix sum of the sizes, so the
+    // clauses can be copied concurrently and the layout does not depend on
+    // the number of threads; note that we move original clauses first so LEQ
+    // clauses would be placed near the beginning
+    size_t nr_orig = clauses.size(), nr_all = nr_orig + learnts.size();
+    auto cref_at = [&](size_t i) -> CRef& {
+        return i < nr_orig ? clauses[i] : learnts[i - nr_orig];
+    };
+    std::vector<uint64_t> offset(nr_all + 1);
+    gc_parallel_for(nr_all, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            // clauses in occurrence lists of SimpSolver may have been moved
+            const Clause& c = ca[cref_at(i)];
+            offset[i + 1] = c.reloced() ? 0 : to.copy_size(c);
+        }
+    });
+    for (size_t i = 0; i < nr_all; ++i) {
+        offset[i + 1] += offset[i];
+    }
+    if (offset[nr_all] > UINT32_MAX - to.size()) {
+        throw OutOfMemoryException();
+    }
+    CRef base = offset[nr_all] ? to.reserve(offset[nr_all]) : 0;
+    gc_parallel_for(nr_all, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            CRef& cr = cref_at(i);
+            if (ca[cr].reloced()) {
+                ca.reloc_done(cr);
+            } else {
+                ca.reloc_to(cr, to, base + offset[i]);
+            }
+        }
+    });
+
+    // XOR reasons are not in the clause lists
+    for (auto& i : xor_reasons) {
+        ca.reloc(i.second, to);
+    }
+
+    // Watchers and reasons may still refer to clauses that are not in the
+    // lists, such as the LEQ watcher of a lit dropped by shrink_leq_to()
+    // after the clause is removed; such clauses are copied sequentially
+    std::atomic<bool> has_orphan{false};
+    auto find_orphans = [&](bool copy) {
+        auto visit = [&](CRef cr) {
+            if (!ca[cr].reloced()) {
+                if (!copy) {
+                    has_orphan.store(true, std::memory_order_relaxed);
+                } else {
+                    ca.reloc(cr, to);
+                }
+            }
+        };
+        auto scan = [&](size_t begin, size_t end) {
+            for (Var v = begin; v < Var(end); v++) {
+                for (int s = 0; s < 2; s++) {
+                    for (const Watcher& w : watches[mkLit(v, s)]) {
+                        visit(w.cref);
+                    }
+                }
+                for (const LeqWatcher& w : leq_watches[v]) {
+                    visit(w.cref);
+                }
+                if (value(v) != l_Undef && reason(v) != CRef_Undef) {
+                    visit(reason(v));
+                }
+            }
+        };
+        if (copy) {
+            scan(0, nVars());
+        } else {
+            gc_parallel_for(nVars(), scan);
+        }
+    };
+    find_orphans(false);
+    if (has_orphan) {
+        find_orphans(true);
+    }
+
+    // All watcher refs:
+    //
+    gc_parallel_for(nVars(), [&](size_t begin, size_t end) {
+        for (Var v = begin; v < Var(end); v++) {
+            for (int s = 0; s < 2; s++) {
+                for (Watcher& w : watches[mkLit(v, s)]) {
+                    ca.reloc_done(w.cref);
+                }
+            }
+            for (LeqWatcher& w : leq_watches[v]) {
+                ca.reloc_done(w.cref);
+            }
+        }
+    });
+
+    // All reasons:
+    // note: reasons only meaningful for vars in the trail
+    gc_parallel_for(trail.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            Var v = var(trail[i]);
+            if (CRef& r = vardata[v].reason; r != CRef_Undef) {
+                ca.reloc_done(r);
+            }
+        }
+    });
+}
+
 void Solver::garbageCollect() {
     // Initialize the next region to a size corresponding to the estimated
     // utilization degree. This is not precise but should avoid some unnecessary
@@ -1913,6 +3145,60 @@ void Solver::garbageCollect() {
     to.moveTo(ca);
 }
 
+size_t Solver::mem_footprint() const {
+    size_t ret = size_t(ca.capacity()) * ClauseAllocator::Unit_Size;
+    ret += watches.memory_bytes() + leq_watches.memory_bytes();
+    ret += (clauses.capacity() + learnts.capacity()) * sizeof(CRef);
+    ret += trail.capacity() * sizeof(Lit) +
+           trail_leq_stat.capacity() * sizeof(LeqStatusModLog);
+    // per-var data (assigns, vardata, activity, polarity, heap and so on)
+    ret += size_t(vardata.capacity()) *
+           (sizeof(lbool) + sizeof(VarData) + sizeof(double) + 4 * sizeof(int) +
+            4 * sizeof(char));
+    return ret;
+}
+
+void Solver::check_memory() {
+    constexpr uint64_t CHECK_INTERVAL = 1000;
+    next_mem_check = conflicts + CHECK_INTERVAL;
+
+    double target = mem_target * 1048576.0, used = mem_footprint();
+    mem_pressure = used > target * 0.75;
+    if (used <= target * 0.9) {
+        return;
+    }
+
+    mem_reductions++;
+    reduceDB();
+    // keep fewer learnts from now on, but leave enough for search to progress
+    constexpr double MIN_MAX_LEARNTS = 1000;
+    max_learnts = std::max(std::min<double>(max_learnts, learnts.size()),
+                           MIN_MAX_LEARNTS);
+    // a copy is sized by the live data, so it also shrinks the region if more
+    // than half of it is unused (regions grow by less than 2x)
+    if (ca.wasted() > ca.size() * (garbage_frac / 4) ||
+        ca.capacity() - ca.size() > ca.capacity() / 2) {
+        garbageCollect();
+    }
+    watches.shrink_to_fit();
+    leq_watches.shrink_to_fit();
+    learnts.shrink_to_fit();
+    clauses.shrink_to_fit();
+    analyze_stack.clear(true);
+    analyze_toclear.clear(true);
+
+    double new_used = mem_footprint();
+    if (new_used > target) {
+        mem_over_target = true;
+    }
+    if (verbosity >= 1) {
+        printf("|  Memory reduction: %9.1f MB => %9.1f MB (target %9d MB)%s     "
+               "|\n",
+               used / 1048576, new_used / 1048576, mem_target,
+               new_used > target ? " !" : "  ");
+    }
+}
+
 int Solver::nLeqClauses() const {
     int ret = 0;
     for (CRef i : clauses) {
@@ -23,15 +23,26 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #ifndef Minisat_Solver_h
 #define Minisat_Solver_h
 
+#include "minisat/core/Features.h"
+#include "minisat/core/Gates.h"
 #include "minisat/core/SolverTypes.h"
+#include "minisat/core/Xor.h"
 #include "minisat/mtl/Alg.h"
 #include "minisat/mtl/Heap.h"
 #include "minisat/mtl/Vec.h"
 #include "minisat/utils/Random.h"
+#include "minisat/utils/ThreadPool.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace Minisat {
 
@@ -39,6 +50,7 @@ namespace Minisat {
 // Solver -- the main class:
 
 class Solver;
+class OutputBuffer;
 
 //! remove vars and corresponding clauses that are referenced by at most one
 //! clause
@@ -62,7 +74,7 @@ class DeadVarRemover {
     };
 
     Solver* const m_solver;
-    bool m_enabled = true;
+    bool m_enabled = true, m_applied = false;
     vec<RefCnt> m_var_refcnt;
     //! vars and corresponding clauses that reference it
     std::vector<std::pair<Var, CRef>> m_var2cref;
@@ -87,13 +99,144 @@ public:
 
     void disable() { m_enabled = false; }
 
+    //! whether any var has been removed
+    bool applied() const { return m_applied; }
+
     void simplify();
 
     //! to be called after a solution is found, so assignments of removed vars
-    //! can be fixed
+    //! can be fixed; unassigned lits of a partial model are assigned false
     void fix_var_assignments();
 };
 
+//! cache of solve() results keyed on assumption sets: a stored UNSAT core
+//! that is a subset of the assumptions proves UNSAT, and a stored model that
+//! satisfies the assumptions proves SAT
+class ResultCache {
+    struct Core {
+        //! bitset signature of the lits for quick subset rejection
+        uint64_t sig;
+        vec<Lit> lits;
+    };
+
+    int m_capacity;
+    //! stored cores and models; the oldest entry is replaced when full
+    std::vector<Core> m_cores;
+    std::vector<vec<lbool>> m_models;
+    int m_core_next = 0, m_model_next = 0;
+    //! marks of assumption lits, indexed by toInt(Lit)
+    vec<char> m_mark;
+
+    static uint64_t signature(Lit p) { return uint64_t(1) << (toInt(p) & 63); }
+
+public:
+    //! @param capacity max number of cores and of models to store; 0 disables
+    //!     the cache
+    explicit ResultCache(int capacity) : m_capacity{capacity} {}
+
+    bool enabled() const { return m_capacity > 0; }
+
+    //! find a stored core that is a subset of @p assumps
+    const vec<Lit>* find_core(const vec<Lit>& assumps);
+
+    //! find a stored model that satisfies @p assumps
+    const vec<lbool>* find_model(const vec<Lit>& assumps) const;
+
+    //! add an UNSAT core given as assumption lits
+    void add_core(const vec<Lit>& core);
+
+    void add_model(const vec<lbool>& model);
+
+    //! models are invalidated when constraints are added
+    void invalidate_models() {
+        m_models.clear();
+        m_model_next = 0;
+    }
+
+    //! cores are invalidated when constraints are removed
+    void invalidate_cores() {
+        m_cores.clear();
+        m_core_next = 0;
+    }
+};
+
+/*!
+ * runs subsumption, failed literal probing and vivification on a snapshot of
+ * the clause database in a helper thread, so that the search goes on
+ *
+ * Snapshots are taken and results are applied by the solver at restarts; see
+ * Solver::bg_simp.
+ */
+class BackgroundSimplifier {
+public:
+    //! constraints copied from the solver; learnts are the clauses from
+    //! #nr_orig on
+    struct Snapshot {
+        struct Leq {
+            int begin, size, bound;
+            Lit dst;
+        };
+        int nr_vars = 0, nr_orig = 0;
+        std::vector<Lit> units;
+        //! lits of all clauses; clause i spans [begin[i], begin[i + 1])
+        std::vector<Lit> lits;
+        std::vector<int> begin{0};
+        std::vector<Lit> leq_lits;
+        std::vector<Leq> leqs;
+        //! propagation and subsumption budget
+        int64_t ticks = 0;
+
+        int nr_clauses() const { return int(begin.size()) - 1; }
+    };
+
+    //! facts implied by a snapshot; learnts are referred to by their index
+    //! among the learnts of the snapshot
+    struct Result {
+        bool unsat = false;
+        std::vector<Lit> units;
+        std::vector<int> deleted;
+        std::vector<std::pair<int, std::vector<Lit>>> strengthened;
+    };
+
+private:
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_has_job = false, m_has_result = false, m_stop = false;
+    std::atomic<bool> m_abort{false};
+    Snapshot m_snapshot;
+    Result m_result;
+    //! var to start probing from, so that rounds cover different vars
+    int m_probe_next = 0;
+
+    void thread_main();
+    void run(const Snapshot& snapshot, Result& result);
+
+    //! mark learnts that are subsumed by other clauses
+    void subsume(const Snapshot& snapshot, Result& result, int64_t& ticks);
+    //! find units by failed literals and by lits implied by both phases
+    void probe(Solver& engine, const Snapshot& snapshot, int64_t& ticks);
+    //! shorten learnts by propagating the negation of their lits
+    void vivify(Solver& engine, const Snapshot& snapshot, Result& result,
+                int64_t& ticks);
+
+public:
+    BackgroundSimplifier() = default;
+    ~BackgroundSimplifier();
+    BackgroundSimplifier(const BackgroundSimplifier&) = delete;
+    BackgroundSimplifier& operator=(const BackgroundSimplifier&) = delete;
+
+    //! whether a snapshot has been submitted and its result not yet taken
+    bool busy();
+
+    //! hand a snapshot to the helper thread, which is started on first use;
+    //! must not be called when busy()
+    void submit(Snapshot&& snapshot);
+
+    //! take the result of the last snapshot if it is ready
+    bool poll(Result& result);
+};
+
 class Solver {
 public:
     // Constructor/Destructor:
@@ -115,12 +258,17 @@ public:
     bool addClause(Lit p, Lit q, Lit r);  // Add a ternary clause to the solver.
     bool addClause_(vec<Lit>& ps);  // Add a clause to the solver without making
                                     // superflous internal copy. Will change the
-                                    // passed vector 'ps'.
-    //! add dst = (src[0]^src_neg) & (src[1]^src_neg) & ...
+                                    // passed vector 'ps'. Can also be called
+                                    // during search (see on_model_candidate()).
+    //! add dst = (src[0]^src_neg) & (src[1]^src_neg) & ...; set @p taint if
+    //! the conjunction is derived from non-base constraints
     template <bool src_neg = false>
-    bool addClauseReifiedConjunction(Lit dst, const Lit* src, int size);
+    bool addClauseReifiedConjunction(Lit dst, const Lit* src, int size,
+                                     bool taint = false);
 
-    //! Add dst = (sum(ps) <= bound) to the solver
+    //! Add dst = (sum(ps) <= bound) to the solver; like addClause_(), this
+    //! can be called during search, but it may backtrack to the level before
+    //! any of the involved vars was assigned
     bool addLeqAssign_(vec<Lit>& ps, int bound, Lit dst);
 
     //! Add dst = (sum(ps) >= bound) to the solver
@@ -128,6 +276,39 @@ public:
         return addLeqAssign_(ps, bound - 1, ~dst);
     }
 
+    //! Add the constraint that the xor of @p ps is true, i.e. an odd number
+    //! of them are true. XORs are handled by Gauss-Jordan elimination instead
+    //! of clauses; adding one backtracks to level 0.
+    bool addXor_(vec<Lit>& ps);
+
+    // Retractable constraint groups:
+    //
+    //! Open a new scope. Clauses and LEQs added until the matching pop() are
+    //! guarded by a selector var that is implicitly assumed by solve(). This
+    //! turns on #incremental mode. Note that SimpSolver variable elimination
+    //! must be turned off before using scopes.
+    void push();
+    //! Close the innermost scope, physically removing its constraints and all
+    //! learnt clauses that depend on them
+    void pop();
+    //! number of currently open scopes
+    int nScopes() const { return scopes.size(); }
+
+    // Learnt clause sharing:
+    //
+    //! Mark whether constraints added from now on belong to the base set.
+    //! Learnt clauses are tainted if their derivation depends on constraints
+    //! outside of the base set (scoped constraints are never in the base set).
+    void set_adding_base(bool flag);
+    //! Collect untainted learnt clauses with LBD at most @p max_lbd and size
+    //! at most @p max_size into #base_learnts. This turns on #incremental
+    //! mode, so it must be called before dead vars are removed.
+    void set_base_learnt_export(int max_lbd, int max_size);
+    //! Add a learnt clause that is implied by the constraints, usually one
+    //! exported by another solver on the same base constraints; @p taint is
+    //! combined with the taint derived from the lits
+    bool import_learnt(vec<Lit>& ps, bool taint = false);
+
     // Solving:
     //
     // Removes already satisfied clauses.
@@ -150,7 +331,43 @@ public:
             FILE* f,
             const vec<Lit>& assumps);  // Write CNF to file in DIMACS-format.
     void toDimacs(const char* file, const vec<Lit>& assumps);
-    void toDimacs(FILE* f, Clause& c, vec<Var>& map, Var& max);
+
+    //! Write the current simplified problem in the extended DIMACS format
+    //! accepted by parse_DIMACS(): root-level units, @p assumps and selectors
+    //! of open scopes as units, clauses and LEQs with root-level values
+    //! substituted, var preferences, and learnt clauses if @p with_learnts is
+    //! set. Variables keep their numbers so models can be used directly,
+    //! unless dead vars have been removed (see #incremental). The output is
+    //! gzip-compressed if @p file ends with ".gz". Return whether the file
+    //! has been written successfully.
+    bool export_dimacs(const char* file, const vec<Lit>& assumps,
+                       bool with_learnts = false);
+    //! write to an OutputBuffer; see export_dimacs()
+    void export_dimacs(OutputBuffer& out, const vec<Lit>& assumps,
+                       bool with_learnts);
+
+    //! statistics of the original constraints for select_profile(); takes
+    //! one pass over the clauses
+    InstanceFeatures extract_features() const;
+    //! set the search parameters of @p profile, except those given explicitly
+    //! on the command line
+    void apply_profile(SolverProfile profile);
+
+    //! find the LEQ, AND and XOR gates encoded by the constraints
+    void extract_gates(GateNetwork& net) const;
+
+    //! SAT sweeping: find equivalent, complementary and constant vars by
+    //! bit-parallel random simulation of the LEQ / gate network, prove each
+    //! candidate with budgeted solve() calls under assumptions, and
+    //! substitute the proven vars by their representatives. Models of
+    //! refuted candidates refine the remaining candidate classes. Only valid
+    //! for a fixed problem, so it must be called before the first solve()
+    //! and disables push(). Return false if the problem is found UNSAT.
+    bool sat_sweep();
+
+    //! assign false to the vars left undefined in a #partial_model, and
+    //! update the vars substituted by sat_sweep() accordingly
+    void complete_model();
 
     // Convenience versions of 'toDimacs()':
     void toDimacs(const char* file);
@@ -201,6 +418,8 @@ public:
     virtual void garbageCollect();
     void checkGarbage(double gf);
     void checkGarbage();
+    //! estimated number of bytes used by clauses, watchers and per-var data
+    size_t mem_footprint() const;
 
     // Extra results: (read-only member variable)
     //
@@ -209,6 +428,8 @@ public:
     vec<Lit> conflict;  // If problem is unsatisfiable (possibly under
                         // assumptions), this vector represent the final
                         // conflict clause expressed in the assumptions.
+    //! learnt clauses collected for export (see set_base_learnt_export())
+    std::vector<vec<Lit>> base_learnts;
 
     // Mode of operation:
     //
@@ -226,6 +447,87 @@ public:
                           // value.
     double garbage_frac;  // The fraction of wasted memory allowed before a
                           // garbage collection is triggered.
+    //! Number of helper threads for garbage collection and level-0 cleanup
+    //! (0 to run them on the search thread); results do not depend on it
+    int gc_threads;
+    //! Set if constraints may be added after the first call to solve or from
+    //! on_model_candidate(); this disables simplifications that are only
+    //! valid for a fixed problem (dead var removal and #symmetry)
+    bool incremental;
+    //! Keep the decision levels of the longest common assumption prefix on
+    //! the trail between calls to solve, and carry over the restart
+    //! sequence, the learnt limit and the phases of the last model. A search
+    //! stopped by its budget keeps all of its levels, and the next call with
+    //! the same assumptions continues it. Note that value() may then report
+    //! assignments from these levels after solve returns.
+    bool reuse_trail;
+    //! Soft limit of mem_footprint() in megabytes (0 to disable). Learnts are
+    //! reduced more aggressively and storage is compacted when approaching
+    //! it; the limit is only exceeded for constraints that can not be reduced.
+    int mem_target;
+    //! Max ticks (literals scanned) of inprocessing passes per propagation
+    double inproc_effort;
+    //! number of 64-bit random simulation words per var in sat_sweep()
+    int sweep_words;
+    //! conflict budget of each solve() call in sat_sweep()
+    int sweep_conflicts;
+    //! total conflict budget of sat_sweep() (0 for no limit)
+    int64_t sweep_max_conflicts;
+    //! Restrict each solve() with assumptions to the cone of influence of
+    //! the assumptions and of the constraints that do not define a gate:
+    //! the vars of gates outside of it are not decided in the call, and the
+    //! gates are evaluated to extend the model. Note that
+    //! on_model_candidate() then may see no values for the vars outside of
+    //! the cone and must not add constraints on them.
+    bool slice;
+    //! Stop the search as soon as every constraint is satisfied, instead of
+    //! deciding all the remaining vars. The vars left unassigned are l_Undef
+    //! in the model (and in on_model_candidate()), and any values for them
+    //! satisfy the problem. Only the inputs of removed dead-var LEQs and
+    //! #slice gates are assigned (to false) when the model is extended;
+    //! complete_model() assigns the others.
+    bool partial_model;
+    //! Find XOR constraints encoded in the clauses at the first solve() and
+    //! add them to the Gauss-Jordan matrices; the clauses are kept
+    bool xor_detect;
+    //! Derive binary relations between the dsts of LEQs that share most of
+    //! their lits at the first solve(), and add them as learnt clauses
+    bool leq_pairs;
+    //! max ticks (occurrences visited) of the #leq_pairs derivation
+    int64_t leq_pair_ticks;
+    //! Find symmetries of the constraints at the first solve() and add
+    //! lex-leader constraints to break them; only applied if the problem is
+    //! not #incremental and has no assumptions, since constraints added later
+    //! may not share the symmetries
+    bool symmetry;
+    //! max ticks (edges visited) of the #symmetry search
+    int64_t sym_ticks;
+    //! max number of vars in the lex-leader constraint of each symmetry
+    int sym_lex_size;
+    //! Solve the linear relaxation of the constraints approximately at the
+    //! first solve() and use the values to set the initial polarities and
+    //! to bump the activities of the vars it is confident about
+    bool lp_phase;
+    //! max number of passes over the constraints in #lp_phase
+    int lp_sweeps;
+    //! also set the #var_preference of the vars that have none by the
+    //! confidence of the relaxation
+    bool lp_pref;
+    //! Compute an elimination order of the primal graph at the first solve()
+    //! and set the #var_preference of the vars that have none by it, so that
+    //! the bags of the tree decomposition are decided from the leaves up
+    bool td_order;
+    //! max ticks (element entries visited) of the #td_order elimination
+    int64_t td_ticks;
+    //! Simplify snapshots of the clause database taken at restarts in a
+    //! helper thread (see BackgroundSimplifier) and apply the units,
+    //! strengthened and deleted learnts at later restarts. Results depend on
+    //! thread timing, so runs are not reproducible.
+    bool bg_simp;
+    //! min number of conflicts between two #bg_simp snapshots
+    int bg_simp_interval;
+    //! propagation and subsumption budget of one #bg_simp round
+    int64_t bg_simp_ticks;
 
     int restart_first;         // The initial restart limit. (default 100)
     double restart_inc;        // The factor with which the restart limit is
@@ -247,6 +549,33 @@ public:
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts;
     uint64_t dec_vars, clauses_literals, learnts_literals, max_literals,
             tot_literals;
+    //! number of successful addClause_() / addLeqAssign_() calls; can be used
+    //! to detect problem modification
+    uint64_t added_constraints;
+    //! number of solve() calls answered by the #result_cache
+    uint64_t cache_hits;
+    //! number of forced reductions due to #mem_target
+    uint64_t mem_reductions;
+    //! whether the footprint stayed above #mem_target after a reduction
+    bool mem_over_target;
+    //! number of solve() calls restricted by #slice, and the total number of
+    //! constraints of the gates outside of their cones
+    uint64_t sliced_solves, sliced_constraints;
+    //! lits implied and conflicts found by the XOR matrices, and the number
+    //! of pivots done during search
+    uint64_t xor_propagations, xor_conflicts, xor_pivots;
+    //! binary clauses and units derived by #leq_pairs
+    uint64_t leq_pair_binaries, leq_pair_units;
+    //! generators found by #symmetry and the clauses added to break them
+    uint64_t sym_generators, sym_clauses;
+    //! vars whose phase was set by #lp_phase
+    uint64_t lp_guided_vars;
+    //! width of the tree decomposition found by #td_order
+    int td_width;
+    //! #bg_simp results applied, and the units, strengthened and deleted
+    //! learnts taken from them
+    uint64_t bg_simp_rounds, bg_simp_units, bg_simp_strengthened,
+            bg_simp_deleted;
 
 protected:
     using abstract_level_set_t = uint_fast32_t;
@@ -258,6 +587,37 @@ protected:
         int level;
     };
 
+    //! Schedule of an inprocessing pass run by simplify(), measured in
+    //! propagations. The interval shrinks if the pass pays off and grows
+    //! otherwise, and it is bounded below so that the ticks spent by the pass
+    //! stay proportional to search effort.
+    struct InprocPass {
+        //! number of propagations at which the pass is run next
+        uint64_t next_run = 0;
+        uint64_t interval;
+        uint64_t nr_run = 0, tot_cost = 0, tot_gain = 0;
+
+        explicit InprocPass(uint64_t init_interval)
+                : interval{init_interval} {}
+
+        bool due(uint64_t propagations) const {
+            return propagations >= next_run;
+        }
+
+        //! reschedule after a run that scanned @p cost literals and removed
+        //! @p gain literals
+        void update(uint64_t propagations, uint64_t cost, int64_t gain,
+                    double effort);
+    };
+
+    //! a constraint scope opened by push()
+    struct Scope {
+        //! the selector var guarding constraints of this scope
+        Var selector;
+        //! start index of vars owned by this scope in #scope_vars
+        int vars_begin;
+    };
+
     struct Watcher {
         CRef cref;
         Lit blocker;
@@ -305,6 +665,8 @@ protected:
     //
     bool ok;  // If FALSE, the constraints are already unsatisfiable. No
               // part of the solver state may be used!
+    //! clause storage; declared before watchers that hold a reference to it
+    ClauseAllocator ca;
     vec<CRef> clauses;  // List of problem clauses.
     vec<CRef> learnts;  // List of learnt clauses.
     double cla_inc;     // Amount to bump next clause with.
@@ -333,6 +695,8 @@ protected:
                 // propagation queue in MiniSat).
     int simpDB_assigns;  // Number of top-level assignments since last execution
                          // of 'simplify()'.
+    //! number of top-level assignments already removed from order_heap
+    int heap_clean_assigns = 0;
     int64_t simpDB_props;  // Remaining number of propagations that must be made
                            // before next execution of 'simplify()'.
     vec<Lit> assumptions;  // Current set of assumptions provided to solve by
@@ -343,11 +707,10 @@ protected:
     bool remove_satisfied;  // Indicates whether possibly inefficient linear
                             // scan for satisfied clauses should be performed in
                             // 'simplify'.
-    //! ensure that global scan would not occur too frequently by requring a
-    //! minimum number of propagations
-    uint64_t next_remove_satisfied_nr_prop = 0;
-
-    ClauseAllocator ca;
+    //! removal of satisfied original clauses and shrinking of LEQs
+    InprocPass inproc_satisfied{300000};
+    //! dead var removal; only valid for a fixed problem
+    InprocPass inproc_dead_vars{300000};
 
     // Temporaries (to reduce allocation overhead). Each variable is prefixed by
     // the method in which it is used, exept 'seen' wich is used in several
@@ -361,6 +724,22 @@ protected:
     double max_learnts;
     double learntsize_adjust_confl;
     int learntsize_adjust_cnt;
+    //! position in the restart sequence; only reset by solve_() if
+    //! #reuse_trail is not set
+    int curr_restarts = 0;
+    //! whether #max_learnts and the adjustment counters have been set up;
+    //! they are only reset by solve_() if #reuse_trail is not set
+    bool learnt_limit_started = false;
+    //! assumptions whose decision levels were kept on the trail by the last
+    //! call to solve_() (see #reuse_trail)
+    vec<Lit> kept_assumptions;
+    //! whether the last call to solve_() was stopped by its budget and kept
+    //! all of its decision levels; they are reused if the next call has the
+    //! same assumptions
+    bool search_kept = false;
+    //! conflicts of the restart interval stopped by the budget, continued by
+    //! the next call to search()
+    int restart_conflicts = 0;
 
     // Resource contraints:
     //
@@ -368,19 +747,165 @@ protected:
     int64_t propagation_budget;  // -1 means no budget.
     volatile bool asynch_interrupt;
 
+    //! currently open scopes, innermost last
+    vec<Scope> scopes;
+    //! selectors and auxiliary vars owned by the open scopes, grouped by scope
+    vec<Var> scope_vars;
+    //! whether a var is in #scope_vars
+    vec<char> is_scope_var;
+
+    //! whether taints are maintained; set once a non-base constraint may exist
+    bool track_taint = false;
+    //! see set_adding_base()
+    bool adding_base = true;
+    //! taint of the constraint being added
+    bool add_taint = false;
+    //! taint of the last clause learnt by analyze()
+    bool analyze_taint = false;
+    //! whether a root level assignment of a var is tainted
+    vec<char> root_taint;
+    //! limits for collecting #base_learnts; export is disabled if size is 0
+    int export_max_lbd = 0, export_max_size = 0;
+
+    ResultCache result_cache;
+    //! value of #added_constraints when models in #result_cache were checked
+    uint64_t cache_added_constraints = 0;
+
+    //! number of conflicts at which the footprint is checked next
+    uint64_t next_mem_check = 0;
+    //! set when the footprint is close to #mem_target
+    bool mem_pressure = false;
+
     // Encapsulated objects
     RandomState random_state;
     friend class DeadVarRemover;
     DeadVarRemover dead_var_remover{this};
 
+    //! implementation of sat_sweep()
+    class Sweeper;
+    //! vars removed by sat_sweep() and the lits they are equal to; used to
+    //! extend the model
+    std::vector<std::pair<Var, Lit>> substituted_vars;
+
+    //! gates used by #slice, valid while #added_constraints equals
+    //! #slice_net_added; #slice_base marks the vars of the constraints that
+    //! define no gate
+    GateNetwork slice_net;
+    std::vector<char> slice_base;
+    bool slice_net_valid = false;
+    uint64_t slice_net_added = 0;
+    //! gates outside of the cone of the current solve() call in topological
+    //! order
+    std::vector<int> slice_gates;
+    //! decision vars outside of the cone, which are not decided in the call
+    vec<Var> slice_vars;
+
+    //! extract #slice_net again if constraints have been added since
+    void update_slice_net();
+    //! stop deciding the vars outside of the cone of influence of the
+    //! assumptions and of the constraints that define no gate
+    void slice_query();
+    //! set the model values of the vars outside of the cone
+    void extend_sliced_model();
+    //! make the vars outside of the cone decision vars again
+    void unslice_query();
+
+    //! (decision level, n): the first n constraints in #clauses are satisfied
+    //! by the assignments up to that level; maintained by
+    //! all_constraints_satisfied() and cancelUntil()
+    std::vector<std::pair<int, int>> sat_scan;
+    //! whether the current assignment satisfies every constraint, scanning
+    //! #clauses from the position recorded for the current branch
+    bool all_constraints_satisfied();
+
+    //! XOR constraints as added; #xor_matrices are built from them
+    std::vector<XorConstraint> xors;
+    //! set when #xors changed since gauss_setup()
+    bool xors_dirty = false;
+    //! set when #xor_detect has been applied
+    bool xors_detected = false;
+    //! one matrix per connected component of the unassigned XOR vars
+    std::vector<XorMatrix> xor_matrices;
+    //! (matrix, column) of each var, or (-1, -1)
+    std::vector<std::pair<int, int>> xor_col;
+    //! clauses allocated as reasons and conflicts of XOR rows, with the trail
+    //! position below which they are freed
+    std::vector<std::pair<int, CRef>> xor_reasons;
+    vec<Lit> xor_lits;
+
+    //! set when #leq_pairs has been applied
+    bool leq_pairs_derived = false;
+    //! derive relations between overlapping LEQs; return false if the
+    //! problem becomes unsatisfiable
+    bool derive_leq_pairs();
+
+    //! set when #symmetry has been applied
+    bool symmetry_broken = false;
+    //! find symmetries and add lex-leader constraints; return false if the
+    //! problem becomes unsatisfiable
+    bool break_symmetries();
+
+    //! set when #lp_phase has been applied
+    bool lp_guided = false;
+    //! set phases and activities from the linear relaxation
+    void lp_guide();
+
+    //! set when #td_order has been applied
+    bool td_ordered = false;
+    //! set var preferences from an approximate tree decomposition
+    void tree_decomp_order();
+
+    friend class BackgroundSimplifier;
+    BackgroundSimplifier bg_simplifier;
+    //! incremented by pop(); results of snapshots taken before constraints
+    //! are removed are discarded
+    uint64_t bg_simp_epoch = 0, bg_simp_snapshot_epoch = 0;
+    //! learnts of the pending snapshot by their index in it; kept up to date
+    //! by garbage collection, CRef_Undef if removed since
+    vec<CRef> bg_simp_learnts;
+    uint64_t bg_simp_next_conflicts = 0;
+    //! apply the result of #bg_simplifier and submit a new snapshot when
+    //! due; called at level 0 between restarts. Return false on conflict.
+    bool bg_simp_exchange();
+    //! apply units, strengthened and deleted learnts found by #bg_simp
+    bool bg_simp_apply(BackgroundSimplifier::Result& result);
+
+    //! find XOR constraints encoded in #clauses
+    void detect_xors();
+    //! build #xor_matrices at level 0; return false if the XORs are
+    //! inconsistent
+    bool gauss_setup();
+    //! propagate the assignment of @p p in the XOR matrices
+    CRef propagate_xor(Lit p);
+    //! an unassigned non-basic column of row @p r, or -1
+    int xor_find_watch(const XorMatrix& m, int r) const;
+    //! propagate the basic var of row @p r whose non-basic columns are all
+    //! assigned, or return the conflict
+    CRef xor_unit(XorMatrix& m, int r);
+    //! re-establish the watch of row @p r after it was changed by a pivot
+    CRef xor_fix_row(XorMatrix& m, int r);
+    //! allocate the reason of @p implied (or a conflict if it is lit_Undef)
+    //! from row @p r
+    CRef xor_alloc(const XorMatrix& m, int r, Lit implied);
+
+    // Extension points:
+    //
+
+    //! Called by search() when all decision vars are assigned without
+    //! conflict. Derived classes can check the candidate model and refine the
+    //! problem by calling addClause_() / addLeqAssign_(); search is resumed
+    //! if any constraint is added, and the model is accepted otherwise.
+    virtual void on_model_candidate() {}
+
     // Main internal methods:
     //
     void insertVarOrder(
             Var x);  // Insert a variable in the decision order priority queue.
     Lit pickBranchLit();      // Return the next decision variable.
     void newDecisionLevel();  // Begins a new decision level.
-    //! Enqueue a literal. Assumes value of literal is undefined.
-    void uncheckedEnqueue(Lit p, CRef from = CRef_Undef);
+    //! Enqueue a literal. Assumes value of literal is undefined. \p taint is
+    //! the root taint of a root level assignment without a reason.
+    void uncheckedEnqueue(Lit p, CRef from = CRef_Undef, bool taint = false);
     //! revert newly added literals in the queue until size is no larger than
     //! target_size
     void dequeueUntil(int target_size);
@@ -397,6 +922,20 @@ protected:
             Lit p, vec<Lit>& out_conflict);  // COULD THIS BE IMPLEMENTED BY THE
                                              // ORDINARIY "analyze" BY SOME
                                              // REASONABLE GENERALIZATION?
+    //! taint of a root level assignment implied by the given clause
+    bool root_reason_taint(const Clause& c) const;
+    //! taint of a constraint over the given lits that is being added; lits
+    //! with root level values may be removed by simplification
+    bool constraint_taint(const vec<Lit>& ps) const;
+    //! whether a learnt clause should be collected into #base_learnts
+    bool should_export_learnt(const vec<Lit>& ps);
+    //! try to answer the query in #assumptions from #result_cache
+    lbool lookup_result_cache();
+    //! express #conflict in user assumptions only
+    void strip_scope_conflict();
+    //! reduce learnts and compact storage if the footprint approaches
+    //! #mem_target
+    void check_memory();
     //! check if a lit is redundant given current visited lits in analyze()
     bool litRedundant(Lit p, abstract_level_set_t abstract_levels);
     lbool search(int nof_conflicts);  // Search for a given number of conflicts.
@@ -404,7 +943,12 @@ protected:
     void reduceDB();  // Reduce the set of learnt clauses.
     void removeSatisfied(vec<CRef>& cs);  // Shrink 'cs' to contain only
                                           // non-satisfied clauses.
+    //! drop watchers of removed LEQs and the LEQ status log after
+    //! constraints have been removed at level 0
+    void cleanLeqWatches();
     void rebuildOrderHeap();
+    //! remove vars assigned at level 0 since the last call from order_heap
+    void cleanOrderHeap();
 
     // Maintaining Variable/Clause activity:
     //
@@ -424,6 +968,25 @@ protected:
 
     // Operations on clauses:
 
+    //! add a clause without the guard of the current scope; @p taint is
+    //! combined with the taint derived from the lits
+    bool addClauseNoGuard_(vec<Lit>& ps, bool taint = false);
+    //! sort the lits and remove duplicated and root-false ones; return false
+    //! if the clause is satisfied at root level
+    bool remove_root_lits(vec<Lit>& ps);
+    //! add an LEQ without the guard of the current scope
+    bool addLeqAssignNoGuard_(vec<Lit>& ps, int bound, Lit dst);
+    //! add an XOR without the guard of the current scope
+    bool addXorNoGuard_(vec<Lit>& ps, bool from_clauses = false);
+    //! allocate a var owned by the innermost scope
+    Var newScopeVar(bool dvar);
+    //! remove clauses involving any var marked in #seen
+    void removeScopeClauses(vec<CRef>& cs);
+    //! write the lines of export_dimacs() after the header, or only count
+    //! them if @p out is null; vars that occur are marked in @p used
+    int export_dimacs_body(OutputBuffer* out, const vec<Lit>& assumps,
+                           bool with_learnts, vec<char>& used);
+
     // LEQ clauses:
     //! remove duplicatations in ps and modify ps and bound inplace
     void canonize_leq_clause(vec<Lit>& ps, int& bound);
@@ -435,6 +998,10 @@ protected:
 
     // disjunction clauses:
     void attachClause(CRef cr);  // Attach a clause to watcher lists.
+    //! attach a clause added at a non-root level: choose watches w.r.t. the
+    //! current assignment, and backtrack / propagate if the clause is unit or
+    //! conflicting
+    void attachClauseInSearch(CRef cr);
     void detachClause(
             CRef cr, bool strict = false);  // Detach a clause to watcher lists.
     void removeClause(CRef cr);             // Detach and free a clause.
@@ -449,10 +1016,25 @@ protected:
     bool try_leq_simplify(Clause& c);
 
     void relocAll(ClauseAllocator& to);
+    //! relocate the clauses on the search thread; learnts are laid out in
+    //! the order their watchers are met
+    void reloc_in_watch_order(ClauseAllocator& to);
+    //! relocate the clauses on #gc_threads helper threads; learnts are laid
+    //! out in list order
+    void reloc_in_list_order(ClauseAllocator& to);
+
+    //! helper threads of #gc_threads, created on first use
+    std::unique_ptr<ThreadPool> gc_pool;
+    //! call fn(begin, end) on ranges covering [0, n), split over #gc_pool
+    //! when the loop is large enough
+    template <typename Fn>
+    void gc_parallel_for(size_t n, Fn&& fn);
 
     // Misc:
     //
     int decisionLevel() const;  // Gives the current decisionlevel.
+    //! value of a literal if it is fixed at level 0, or l_Undef otherwise
+    lbool rootValue(Lit p) const;
     //! get an abstract representation of the level of var
     abstract_level_set_t abstractLevel(Var x) const;
     // sets of decision levels.
@@ -534,13 +1116,28 @@ inline void Solver::claBumpActivity(Clause& c) {
 }
 
 inline void Solver::checkGarbage(void) {
-    return checkGarbage(garbage_frac);
+    // compact earlier under memory pressure
+    return checkGarbage(mem_pressure ? garbage_frac / 4 : garbage_frac);
 }
 inline void Solver::checkGarbage(double gf) {
     if (ca.wasted() > ca.size() * gf)
         garbageCollect();
 }
 
+template <typename Fn>
+void Solver::gc_parallel_for(size_t n, Fn&& fn) {
+    // smaller loops are not worth waking the helpers for
+    constexpr size_t GRAIN = 4096;
+    if (gc_threads > 0 && n > GRAIN) {
+        if (!gc_pool || gc_pool->nr_helpers() != gc_threads) {
+            gc_pool = std::make_unique<ThreadPool>(gc_threads);
+        }
+        gc_pool->parallel_for(n, GRAIN, fn);
+    } else if (n) {
+        fn(size_t(0), n);
+    }
+}
+
 inline bool Solver::addClause(const vec<Lit>& ps) {
     ps.copyTo(add_tmp);
     return addClause_(add_tmp);
@@ -578,6 +1175,13 @@ inline void Solver::newDecisionLevel() {
 inline int Solver::decisionLevel() const {
     return trail_lim.size();
 }
+inline lbool Solver::rootValue(Lit p) const {
+    lbool v = value(p);
+    if (v.is_not_undef() && level(var(p)) != 0) {
+        return l_Undef;
+    }
+    return v;
+}
 inline Solver::abstract_level_set_t Solver::abstractLevel(Var x) const {
     return static_cast<abstract_level_set_t>(1)
            << (level(x) & (sizeof(abstract_level_set_t) * 8 - 1));
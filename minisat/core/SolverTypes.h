@@ -225,6 +225,8 @@ class Clause {
      * 3. If is_leq is true, there would be two extra data items: one is
      *    leq_dst, the other is leq_bound
      * 4. Layout for LEQ clauses: header, lits[], dst, bound, status
+     * 5. tainted is set if the clause depends on constraints outside of the
+     *    base set (see Solver::set_adding_base())
      */
     struct {
         unsigned mark : 2;
@@ -232,7 +234,8 @@ class Clause {
         unsigned is_leq : 1;
         unsigned has_extra : 1;
         unsigned reloced : 1;
-        unsigned size : 26;
+        unsigned tainted : 1;
+        unsigned size : 25;
     } header;
     union Data {
         Lit lit;
@@ -252,7 +255,7 @@ class Clause {
     Clause(const V& ps, bool use_extra, bool learnt, bool is_leq) {
         assert(!learnt || !is_leq);
         assert(!use_extra || !is_leq);
-        assert(ps.size() < (1 << 26));
+        assert(ps.size() < (1 << 25));
         // leq size determined by LeqStatus and LeqWatcher
         assert(!is_leq || ps.size() < (1 << 14));
 
@@ -261,6 +264,7 @@ class Clause {
         header.is_leq = is_leq;
         header.has_extra = use_extra;
         header.reloced = 0;
+        header.tainted = 0;
         header.size = ps.size();
 
         for (int i = 0; i < ps.size(); i++) {
@@ -310,6 +314,8 @@ public:
     bool has_extra() const { return header.has_extra; }
     uint32_t mark() const { return header.mark; }
     void mark(uint32_t m) { header.mark = m; }
+    bool tainted() const { return header.tainted; }
+    void tainted(bool t) { header.tainted = t; }
     Lit last() const { return data[header.size - 1].lit; }
 
     const Lit* lit_data() const {
@@ -434,23 +440,54 @@ public:
             cr = c.relocation();
             return;
         }
+        reloc_to(cr, to, to.reserve(to.copy_size(c)));
+    }
+
+    //! number of words taken by a copy of \p c in this allocator
+    uint32_t copy_size(const Clause& c) const {
+        return clauseWord32Size(c.size(), c.learnt() | extra_clause_field,
+                                c.is_leq());
+    }
+
+    //! allocate \p size words to be filled by reloc_to()
+    CRef reserve(uint32_t size) { return Super::alloc(size); }
 
+    //! relocate a clause that has not been relocated to \p dst in \p to,
+    //! where copy_size() words have been reserved; clauses at disjoint
+    //! locations can be relocated concurrently
+    void reloc_to(CRef& cr, ClauseAllocator& to, CRef dst) {
+        Clause& c = operator[](cr);
+        assert(!c.reloced());
+
+        bool use_extra = c.learnt() | to.extra_clause_field;
+        Clause* cl = new (to.lea(dst)) Clause{c, use_extra, c.learnt(),
+                                              c.is_leq()};
         if (c.is_leq()) {
-            cr = to.alloc(c, c.learnt(), c.leq_dst(), c.leq_bound());
-            to[cr].leq_status() = c.leq_status();
-        } else {
-            cr = to.alloc(c, c.learnt());
+            cl->data[c.size()].lit = c.leq_dst();
+            cl->data[c.size() + 1].leq_bound = c.leq_bound();
+            cl->leq_status() = c.leq_status();
         }
-        c.record_relocate(cr);
 
         // Copy extra data-fields:
         // (This could be cleaned-up. Generalize Clause-constructor to be
         // applicable here instead?)
-        to[cr].mark(c.mark());
-        if (to[cr].learnt())
-            to[cr].activity() = c.activity();
-        else if (to[cr].has_extra())
-            to[cr].calcAbstraction();
+        cl->mark(c.mark());
+        cl->tainted(c.tainted());
+        if (cl->learnt())
+            cl->activity() = c.activity();
+        else if (cl->has_extra())
+            cl->calcAbstraction();
+
+        c.record_relocate(dst);
+        cr = dst;
+    }
+
+    //! update \p cr to the new location of a relocated clause; unlike
+    //! reloc(), this never allocates and can be called concurrently
+    void reloc_done(CRef& cr) const {
+        const Clause& c = operator[](cr);
+        assert(c.reloced());
+        cr = c.relocation();
     }
 };
 
@@ -496,6 +533,32 @@ public:
 
     void cleanAll();
 
+    /*!
+     * same as cleanAll(), but the lists are cleaned by
+     * par_for(n, fn) that calls fn(begin, end) on ranges covering [0, n);
+     * the refresh functor must be safe to call concurrently on different
+     * lists
+     */
+    template <typename ParFor>
+    void cleanAll(ParFor&& par_for);
+
+    //! number of bytes allocated for the lists
+    size_t memory_bytes() const {
+        size_t ret = m_occs.capacity() * sizeof(Vec) + m_dirty.capacity() +
+                     m_dirties.capacity() * sizeof(Idx);
+        for (auto&& i : m_occs) {
+            ret += i.capacity() * sizeof(i[0]);
+        }
+        return ret;
+    }
+
+    //! release unused capacity of the lists; should be called after cleanAll()
+    void shrink_to_fit() {
+        for (auto&& i : m_occs) {
+            i.shrink_to_fit();
+        }
+    }
+
     //! mark that watchers in a given index should be refreshed
     void smudge(const Idx& idx) {
         if (m_dirty[toInt(idx)] == 0) {
@@ -528,6 +591,28 @@ void OccLists<Idx, Vec, Refresh>::cleanAll() {
     m_dirties.clear();
 }
 
+template <class Idx, class Vec, class Refresh>
+template <typename ParFor>
+void OccLists<Idx, Vec, Refresh>::cleanAll(ParFor&& par_for) {
+    // remove the duplicates first so that each list is cleaned only once;
+    // clean() would reset the flags anyway
+    int j = 0;
+    for (int i = 0; i < m_dirties.size(); ++i) {
+        Idx x = m_dirties[i];
+        if (m_dirty[toInt(x)]) {
+            m_dirty[toInt(x)] = 0;
+            m_dirties[j++] = x;
+        }
+    }
+    m_dirties.shrink(m_dirties.size() - j);
+    par_for(m_dirties.size(), [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            clean(m_dirties[i]);
+        }
+    });
+    m_dirties.clear();
+}
+
 template <class Idx, class Vec, class Refresh>
 void OccLists<Idx, Vec, Refresh>::clean(const Idx& idx) {
     Vec& vec = m_occs[toInt(idx)];
@@ -0,0 +1,575 @@
+/***************************************************************************************[Sweep.cc]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "minisat/core/Solver.h"
+#include "minisat/utils/System.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+using namespace Minisat;
+
+/* ================== Sweeper ================== */
+
+/*!
+ * The network consists of the LEQs, whose dst is defined by its lits, and of
+ * AND gates recognized in the clauses. All other vars are inputs and get
+ * random values; the gates are evaluated 64 patterns at a time in
+ * topological order. Vars whose value vectors are equal up to negation form
+ * candidate classes, and those whose vectors are constant are candidate
+ * constants. Every model found while refuting a candidate is appended to the
+ * value vectors, which splits all classes that it distinguishes.
+ */
+class Solver::Sweeper {
+    Solver& m_solver;
+    const int m_nr_var, m_nr_words;
+
+    GateNetwork m_net;
+    //! whether a var occurs in any constraint
+    std::vector<char> m_used;
+
+    //! simulation values, m_nr_words per var
+    std::vector<uint64_t> m_sim;
+    //! values in models of refuted candidates; m_cex[i][v] holds models
+    //! [64*i, 64*i+64) for var v
+    std::vector<std::vector<uint64_t>> m_cex;
+    int m_nr_cex = 0;
+
+    //! proven representative of each var
+    std::vector<Lit> m_repr;
+    //! vars whose proof ran out of budget
+    std::vector<char> m_gave_up;
+
+    int64_t m_conflicts_begin;
+    int m_nr_calls = 0, m_nr_proven = 0, m_nr_const = 0, m_nr_refuted = 0,
+        m_nr_unknown = 0, m_nr_substituted = 0;
+
+    void simulate();
+
+    //! value of var @p v in the given simulation or counterexample word, with
+    //! the sign normalized so that the first simulation pattern is false
+    uint64_t sim_word(Var v, int w) const {
+        return m_sim[size_t(v) * m_nr_words + w] ^ flip_mask(v);
+    }
+    uint64_t cex_word(Var v, int w) const { return m_cex[w][v] ^ flip_mask(v); }
+    //! mask of valid bits of counterexample word @p w
+    uint64_t cex_mask(int w) const {
+        int rem = m_nr_cex - w * 64;
+        return rem >= 64 ? ~uint64_t(0) : (uint64_t(1) << rem) - 1;
+    }
+    uint64_t flip_mask(Var v) const {
+        return -(m_sim[size_t(v) * m_nr_words] & 1);
+    }
+    //! lit of @p v whose first simulation pattern is false
+    Lit norm_lit(Var v) const {
+        return mkLit(v, m_sim[size_t(v) * m_nr_words] & 1);
+    }
+
+    bool is_candidate(Var v) const;
+    uint64_t hash(Var v) const;
+    bool same_class(Var u, Var v) const;
+    //! whether the counterexamples distinguish the normalized lits of @p u and
+    //! @p v, or show that @p u is not constant if @p v is var_Undef
+    bool distinguished(Var u, Var v) const;
+
+    //! split the candidates into classes with inputs first and gates in
+    //! topological order; constant classes are marked by a var_Undef
+    //! representative
+    void build_classes(std::vector<std::vector<Var>>& classes) const;
+
+    bool out_of_budget() const;
+    //! solve under @p assumps with the per-call conflict budget; the model
+    //! is recorded as a counterexample if it is SAT
+    lbool solve(const vec<Lit>& assumps);
+    //! prove that @p p implies @p q and add the implication as a clause
+    lbool prove_implication(Lit p, Lit q);
+    //! return whether any new counterexample has been found
+    bool sweep_class(const std::vector<Var>& cls);
+
+    Lit find_repr(Lit p) const {
+        while (m_repr[var(p)] != lit_Undef) {
+            p = m_repr[var(p)] ^ sign(p);
+        }
+        return p;
+    }
+    //! keep vars whose substitution would make an LEQ refer to its own dst
+    void resolve_self_refs();
+    void substitute();
+
+    void print(double time) const;
+
+public:
+    explicit Sweeper(Solver& solver)
+            : m_solver{solver},
+              m_nr_var{solver.nVars()},
+              m_nr_words{solver.sweep_words},
+              m_used(m_nr_var, 0),
+              m_repr(m_nr_var, lit_Undef),
+              m_gave_up(m_nr_var, 0),
+              m_conflicts_begin(solver.conflicts) {}
+
+    bool run();
+};
+
+void Solver::Sweeper::simulate() {
+    Solver& S = m_solver;
+    const int W = m_nr_words;
+    m_sim.resize(size_t(m_nr_var) * W);
+    for (Var v = 0; v < m_nr_var; ++v) {
+        uint64_t* dst = &m_sim[size_t(v) * W];
+        if (S.value(v) != l_Undef) {
+            std::fill(dst, dst + W, S.value(v) == l_True ? ~uint64_t(0) : 0);
+        } else if (m_net.gate_of[v] == -1) {
+            for (int w = 0; w < W; ++w) {
+                dst[w] = S.random_state.bits();
+            }
+        }
+    }
+
+    // the sum of the lits is kept as a bit-sliced binary counter, so one
+    // word operation updates 64 patterns
+    std::vector<uint64_t> cnt;
+    for (const GateNetwork::Gate& g : m_net.gates) {
+        Var v = var(g.out);
+        const Lit* lits = m_net.gate_lits(g);
+        if (g.is_xor) {
+            for (int w = 0; w < W; ++w) {
+                uint64_t x = -uint64_t(sign(g.out));
+                for (int i = 0; i < g.size; ++i) {
+                    x ^= m_sim[size_t(var(lits[i])) * W + w] ^
+                         -uint64_t(sign(lits[i]));
+                }
+                m_sim[size_t(v) * W + w] = x;
+            }
+            continue;
+        }
+        int nr_bits = 1;
+        while ((1 << nr_bits) <= g.size) {
+            ++nr_bits;
+        }
+        cnt.resize(nr_bits);
+        for (int w = 0; w < W; ++w) {
+            std::fill(cnt.begin(), cnt.end(), 0);
+            for (int i = 0; i < g.size; ++i) {
+                uint64_t carry = m_sim[size_t(var(lits[i])) * W + w] ^
+                                 -uint64_t(sign(lits[i]));
+                for (int j = 0; j < nr_bits && carry; ++j) {
+                    uint64_t t = cnt[j] & carry;
+                    cnt[j] ^= carry;
+                    carry = t;
+                }
+            }
+            // compare with the bound from the most significant bit
+            uint64_t gt = 0, eq = ~uint64_t(0);
+            for (int j = nr_bits - 1; j >= 0; --j) {
+                if ((g.bound >> j) & 1) {
+                    eq &= cnt[j];
+                } else {
+                    gt |= eq & cnt[j];
+                    eq &= ~cnt[j];
+                }
+            }
+            m_sim[size_t(v) * W + w] = ~gt ^ -uint64_t(sign(g.out));
+        }
+    }
+}
+
+bool Solver::Sweeper::is_candidate(Var v) const {
+    return m_used[v] && m_solver.decision[v] && m_solver.value(v) == l_Undef &&
+           m_repr[v] == lit_Undef && !m_gave_up[v];
+}
+
+uint64_t Solver::Sweeper::hash(Var v) const {
+    uint64_t h = 0;
+    auto mix = [&h](uint64_t x) { h = (h ^ x) * 0x9e3779b97f4a7c15ull; };
+    for (int w = 0; w < m_nr_words; ++w) {
+        mix(sim_word(v, w));
+    }
+    for (int w = 0; w < int(m_cex.size()); ++w) {
+        mix(cex_word(v, w) & cex_mask(w));
+    }
+    return h;
+}
+
+bool Solver::Sweeper::same_class(Var u, Var v) const {
+    for (int w = 0; w < m_nr_words; ++w) {
+        if (sim_word(u, w) != sim_word(v, w)) {
+            return false;
+        }
+    }
+    return !distinguished(u, v);
+}
+
+bool Solver::Sweeper::distinguished(Var u, Var v) const {
+    for (int w = 0; w < int(m_cex.size()); ++w) {
+        uint64_t x = cex_word(u, w);
+        if (v != var_Undef) {
+            x ^= cex_word(v, w);
+        }
+        if (x & cex_mask(w)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Solver::Sweeper::build_classes(
+        std::vector<std::vector<Var>>& classes) const {
+    classes.clear();
+    std::vector<std::pair<uint64_t, Var>> keyed;
+    for (Var v = 0; v < m_nr_var; ++v) {
+        if (is_candidate(v)) {
+            keyed.push_back({hash(v), v});
+        }
+    }
+    std::sort(keyed.begin(), keyed.end());
+
+    auto is_const = [this](Var v) {
+        for (int w = 0; w < m_nr_words; ++w) {
+            if (sim_word(v, w)) {
+                return false;
+            }
+        }
+        return !distinguished(v, var_Undef);
+    };
+    auto by_order = [this](Var a, Var b) {
+        return std::make_pair(m_net.gate_of[a], a) <
+               std::make_pair(m_net.gate_of[b], b);
+    };
+
+    std::vector<Var> group;
+    for (size_t i = 0, j; i < keyed.size(); i = j) {
+        for (j = i + 1; j < keyed.size() && keyed[j].first == keyed[i].first;
+             ++j)
+            ;
+        if (j - i == 1 && !is_const(keyed[i].second)) {
+            continue;
+        }
+        group.clear();
+        for (size_t k = i; k < j; ++k) {
+            group.push_back(keyed[k].second);
+        }
+        // hash collisions are rare, so the quadratic split is fine
+        while (!group.empty()) {
+            std::vector<Var> cls{group[0]};
+            size_t nr_left = 0;
+            for (size_t k = 1; k < group.size(); ++k) {
+                if (same_class(group[0], group[k])) {
+                    cls.push_back(group[k]);
+                } else {
+                    group[nr_left++] = group[k];
+                }
+            }
+            group.resize(nr_left);
+            std::sort(cls.begin(), cls.end(), by_order);
+            if (is_const(cls[0])) {
+                cls.insert(cls.begin(), var_Undef);
+            }
+            if (cls.size() > 1) {
+                classes.emplace_back(std::move(cls));
+            }
+        }
+    }
+}
+
+bool Solver::Sweeper::out_of_budget() const {
+    const Solver& S = m_solver;
+    return !S.ok || S.asynch_interrupt ||
+           (S.sweep_max_conflicts > 0 &&
+            int64_t(S.conflicts) - m_conflicts_begin >= S.sweep_max_conflicts);
+}
+
+lbool Solver::Sweeper::solve(const vec<Lit>& assumps) {
+    Solver& S = m_solver;
+    ++m_nr_calls;
+    S.setConfBudget(S.sweep_conflicts);
+    lbool ret = S.solveLimited(assumps);
+    S.cancelUntil(0);
+    if (ret == l_True) {
+        if (m_nr_cex % 64 == 0) {
+            m_cex.emplace_back(m_nr_var, 0);
+        }
+        std::vector<uint64_t>& dst = m_cex.back();
+        uint64_t bit = uint64_t(1) << (m_nr_cex % 64);
+        for (Var v = 0; v < m_nr_var; ++v) {
+            if (S.model[v] == l_True) {
+                dst[v] |= bit;
+            }
+        }
+        ++m_nr_cex;
+    }
+    return ret;
+}
+
+lbool Solver::Sweeper::prove_implication(Lit p, Lit q) {
+    vec<Lit> assumps;
+    assumps.push(p);
+    if (q != lit_Undef) {
+        assumps.push(~q);
+    }
+    lbool ret = solve(assumps);
+    if (ret == l_False && m_solver.ok) {
+        // the final conflict is a subset of the negated assumptions
+        vec<Lit> ps;
+        for (Lit r : m_solver.conflict) {
+            ps.push(r);
+        }
+        m_solver.addClause_(ps);
+    }
+    return ret;
+}
+
+bool Solver::Sweeper::sweep_class(const std::vector<Var>& cls) {
+    Var rep = cls[0];
+    Lit rep_lit = rep == var_Undef ? lit_Undef : norm_lit(rep);
+    bool found_cex = false;
+    for (size_t i = 1; i < cls.size(); ++i) {
+        Var v = cls[i];
+        if (out_of_budget()) {
+            break;
+        }
+        if (!is_candidate(v) || (rep != var_Undef && !is_candidate(rep)) ||
+            distinguished(v, rep)) {
+            // already refuted by a model of this round
+            continue;
+        }
+        Lit p = norm_lit(v);
+        // p is expected to be equal to rep_lit, or false for constants
+        lbool ret = prove_implication(p, rep_lit);
+        if (ret == l_False && rep_lit != lit_Undef) {
+            ret = prove_implication(rep_lit, p);
+        }
+        if (ret == l_True) {
+            ++m_nr_refuted;
+            found_cex = true;
+        } else if (ret == l_Undef) {
+            if (!m_solver.ok) {
+                break;
+            }
+            ++m_nr_unknown;
+            m_gave_up[v] = 1;
+        } else if (rep_lit == lit_Undef) {
+            // the unit ~p has been added
+            ++m_nr_const;
+        } else {
+            ++m_nr_proven;
+            m_repr[v] = rep_lit ^ sign(p);
+        }
+    }
+    return found_cex;
+}
+
+void Solver::Sweeper::resolve_self_refs() {
+    Solver& S = m_solver;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (CRef cr : S.clauses) {
+            const Clause& c = S.ca[cr];
+            if (!c.is_leq()) {
+                continue;
+            }
+            Var dst = var(c.leq_dst());
+            Var dst_repr = var(find_repr(c.leq_dst()));
+            for (int i = 0; i < c.size(); ++i) {
+                Var v = var(c[i]);
+                if (v == dst || var(find_repr(c[i])) != dst_repr) {
+                    continue;
+                }
+                // the equivalence is still enforced by the binary clauses
+                // added by prove_implication()
+                m_repr[m_repr[dst] != lit_Undef ? dst : v] = lit_Undef;
+                changed = true;
+                break;
+            }
+        }
+    }
+}
+
+void Solver::Sweeper::substitute() {
+    Solver& S = m_solver;
+    for (Var v = 0; v < m_nr_var; ++v) {
+        if (m_repr[v] != lit_Undef &&
+            (S.value(v) != l_Undef || S.value(m_repr[v]) != l_Undef)) {
+            // root values are substituted by simplification anyway
+            m_repr[v] = lit_Undef;
+        }
+    }
+    resolve_self_refs();
+
+    auto touched = [this](const Clause& c) {
+        for (int i = 0; i < c.size(); ++i) {
+            if (m_repr[var(c[i])] != lit_Undef) {
+                return true;
+            }
+        }
+        return c.is_leq() && m_repr[var(c.leq_dst())] != lit_Undef;
+    };
+
+    struct Rewritten {
+        vec<Lit> lits;
+        Lit dst;
+        int bound;
+        bool taint;
+    };
+    std::vector<Rewritten> rewritten;
+    int i, j;
+    for (i = j = 0; i < S.clauses.size(); ++i) {
+        CRef cr = S.clauses[i];
+        const Clause& c = S.ca[cr];
+        if (!touched(c)) {
+            S.clauses[j++] = cr;
+            continue;
+        }
+        rewritten.emplace_back();
+        Rewritten& r = rewritten.back();
+        for (int k = 0; k < c.size(); ++k) {
+            r.lits.push(find_repr(c[k]));
+        }
+        r.dst = c.is_leq() ? find_repr(c.leq_dst()) : lit_Undef;
+        r.bound = c.is_leq() ? c.leq_bound() : 0;
+        r.taint = c.tainted();
+        S.removeClause(cr);
+    }
+    S.clauses.shrink(i - j);
+    // the gates used by slicing may refer to the substituted vars
+    S.slice_net_valid = false;
+
+    // learnts are implied by the rewritten constraints, but it is cheaper to
+    // drop the few that refer to substituted vars
+    for (i = j = 0; i < S.learnts.size(); ++i) {
+        CRef cr = S.learnts[i];
+        if (touched(S.ca[cr])) {
+            S.removeClause(cr);
+        } else {
+            S.learnts[j++] = cr;
+        }
+    }
+    S.learnts.shrink(i - j);
+
+    S.watches.cleanAll();
+    S.cleanLeqWatches();
+
+    for (Var v = 0; v < m_nr_var; ++v) {
+        if (m_repr[v] != lit_Undef) {
+            S.setDecisionVar(v, false);
+            S.substituted_vars.push_back({v, m_repr[v]});
+            ++m_nr_substituted;
+        }
+    }
+
+    for (Rewritten& r : rewritten) {
+        if (!S.ok) {
+            break;
+        }
+        if (r.dst == lit_Undef) {
+            S.addClauseNoGuard_(r.lits, r.taint);
+        } else {
+            S.addLeqAssignNoGuard_(r.lits, r.bound, r.dst);
+        }
+    }
+    S.checkGarbage();
+}
+
+void Solver::Sweeper::print(double time) const {
+    char buf[128];
+    auto row = [&buf]() { printf("|  %-74s |\n", buf); };
+    printf("==============================[ SAT Sweeping ]"
+           "=================================\n");
+    snprintf(buf, sizeof(buf),
+             "Gates: %d (%d AND, %d XOR)   Inputs: %d   Patterns: %d",
+             int(m_net.gates.size()), m_net.nr_and, m_net.nr_xor,
+             m_nr_var - int(m_net.gates.size()), m_nr_words * 64);
+    row();
+    snprintf(buf, sizeof(buf),
+             "Candidates: %d proven  %d constant  %d refuted  %d unknown",
+             m_nr_proven, m_nr_const, m_nr_refuted, m_nr_unknown);
+    row();
+    snprintf(buf, sizeof(buf),
+             "Substituted vars: %d   SAT calls: %d   Conflicts: %" PRId64
+             "   Time: %.2f s",
+             m_nr_substituted, m_nr_calls,
+             int64_t(m_solver.conflicts) - m_conflicts_begin, time);
+    row();
+}
+
+bool Solver::Sweeper::run() {
+    Solver& S = m_solver;
+    double start = cpuTime();
+    // simplify() is not called here since dead var removal has to see the
+    // substituted problem
+    if (!S.ok || S.propagate() != CRef_Undef) {
+        return S.ok = false;
+    }
+    int verbosity = S.verbosity;
+    int64_t conflict_budget = S.conflict_budget,
+            propagation_budget = S.propagation_budget;
+    S.verbosity = 0;
+
+    S.extract_gates(m_net);
+    for (CRef cr : S.clauses) {
+        const Clause& c = S.ca[cr];
+        for (int i = 0; i < c.size(); ++i) {
+            m_used[var(c[i])] = 1;
+        }
+        if (c.is_leq()) {
+            m_used[var(c.leq_dst())] = 1;
+        }
+    }
+    simulate();
+    std::vector<std::vector<Var>> classes;
+    for (bool found_cex = true; found_cex && !out_of_budget();) {
+        found_cex = false;
+        build_classes(classes);
+        for (auto& cls : classes) {
+            if (out_of_budget()) {
+                break;
+            }
+            found_cex |= sweep_class(cls);
+        }
+    }
+
+    S.verbosity = verbosity;
+    S.conflict_budget = conflict_budget;
+    S.propagation_budget = propagation_budget;
+    if (S.ok) {
+        substitute();
+    }
+    if (S.ok && !S.simplify()) {
+        S.ok = false;
+    }
+    if (verbosity > 0) {
+        print(cpuTime() - start);
+    }
+    return S.ok;
+}
+
+bool Solver::sat_sweep() {
+    minisat_uassert(!incremental && !scopes.size(),
+                    "SAT sweeping is only valid for a fixed problem");
+    minisat_uassert(!solves && !dead_var_remover.applied(),
+                    "SAT sweeping must be done before solving");
+    minisat_uassert(xors.empty(),
+                    "SAT sweeping does not support XOR constraints");
+    cancelUntil(0);
+    Sweeper sweeper{*this};
+    return sweeper.run();
+}
@@ -0,0 +1,448 @@
+/************************************************************************************[Symmetry.cc]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "minisat/core/Solver.h"
+
+#include <algorithm>
+#include <numeric>
+
+using namespace Minisat;
+
+/*
+ * Symmetries are found as automorphisms of a colored graph with two vertices
+ * per var (its lits, joined by an edge), one vertex per clause and per LEQ
+ * joined to their lits, and a dst vertex between each LEQ and its dst lit.
+ * LEQs are colored by their bound and lits by their root value. The search
+ * is the individualization-refinement scheme of nauty and saucy: colorings
+ * are refined until equitable, and a generator mapping v to w is searched
+ * for by individualizing v in one coloring and w in the other and following
+ * the first path to a discrete coloring, backtracking on a mismatch. Each
+ * node first tries to fix all vertices outside of singleton cells, which
+ * finds most generators without descending.
+ * Generators are found top-down along the path of the base points, skipping
+ * targets already in the orbit of the generators of the same level.
+ *
+ * Each generator is broken by the lex-leader constraint over the first vars
+ * (by index) that it moves, encoded with a chain of equality vars as in
+ * BreakID (Devriendt et al., SAT 2016).
+ */
+
+namespace {
+//! max search nodes tried to find one generator
+constexpr int MAX_SEARCH_NODES = 256;
+
+uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+//! a vertex-colored undirected graph in adjacency array form
+struct ColoredGraph {
+    std::vector<int> color, adj_begin, adj;
+
+    int size() const { return color.size(); }
+    const int* adj_of(int v) const { return adj.data() + adj_begin[v]; }
+    int degree(int v) const { return adj_begin[v + 1] - adj_begin[v]; }
+};
+
+class AutomorphismSearch {
+    const ColoredGraph& m_g;
+    const int64_t m_max_ticks;
+    int64_t m_ticks = 0;
+    int m_nodes = 0;
+
+    struct Key {
+        int color;
+        uint64_t hash;
+        int vtx;
+        bool operator<(const Key& rhs) const {
+            return color != rhs.color ? color < rhs.color : hash < rhs.hash;
+        }
+        bool operator!=(const Key& rhs) const {
+            return color != rhs.color || hash != rhs.hash;
+        }
+    };
+    std::vector<Key> m_keys[2];
+    std::vector<int> m_stamp;
+    int m_cur_stamp = 0;
+
+    //! refine one coloring, or two in lockstep, until it is equitable: each
+    //! vertex is recolored by its color and the multiset of the colors of
+    //! its neighbors; return false if the two diverge
+    bool refine(std::vector<int>* cols[], int nr_side);
+    bool refine(std::vector<int>& col) {
+        std::vector<int>* cols[1] = {&col};
+        return refine(cols, 1);
+    }
+    bool refine(std::vector<int>& a, std::vector<int>& b) {
+        std::vector<int>* cols[2] = {&a, &b};
+        return refine(cols, 2);
+    }
+
+    //! find an automorphism consistent with the equal colorings @p l and @p r
+    bool search(const std::vector<int>& l, const std::vector<int>& r,
+                std::vector<int>& perm);
+
+    bool is_automorphism(const std::vector<int>& perm);
+
+    //! a smallest cell with more than one vertex, or -1 if @p col is
+    //! discrete; @p cnt is set to the size of each cell
+    int target_cell(const std::vector<int>& col, std::vector<int>& cnt) const;
+
+    //! map the vertices of singleton cells by @p l and @p r and the others
+    //! to themselves; most symmetries are found this way without descending
+    //! to a discrete coloring
+    bool complete_by_identity(const std::vector<int>& l,
+                              const std::vector<int>& r,
+                              const std::vector<int>& cnt,
+                              std::vector<int>& perm);
+
+public:
+    std::vector<std::vector<int>> generators;
+
+    AutomorphismSearch(const ColoredGraph& g, int64_t max_ticks)
+            : m_g{g}, m_max_ticks{max_ticks}, m_stamp(g.size(), 0) {}
+
+    void run();
+    int64_t ticks() const { return m_ticks; }
+};
+
+bool AutomorphismSearch::refine(std::vector<int>* cols[], int nr_side) {
+    int n = m_g.size(), nr_colors = -1;
+    for (;;) {
+        for (int s = 0; s < nr_side; ++s) {
+            const std::vector<int>& col = *cols[s];
+            std::vector<Key>& keys = m_keys[s];
+            keys.resize(n);
+            for (int v = 0; v < n; ++v) {
+                uint64_t h = 0;
+                for (int i = 0, d = m_g.degree(v); i < d; ++i) {
+                    h += mix64(col[m_g.adj_of(v)[i]]);
+                }
+                keys[v] = {col[v], h, v};
+            }
+            std::sort(keys.begin(), keys.end());
+        }
+        m_ticks += int64_t(nr_side) * (m_g.adj.size() + n);
+        if (nr_side == 2) {
+            for (int v = 0; v < n; ++v) {
+                if (m_keys[0][v] != m_keys[1][v]) {
+                    return false;
+                }
+            }
+        }
+        int cnt = 0;
+        for (int s = 0; s < nr_side; ++s) {
+            std::vector<int>& col = *cols[s];
+            const std::vector<Key>& keys = m_keys[s];
+            cnt = 0;
+            for (int i = 0; i < n; ++i) {
+                cnt += i && keys[i] != keys[i - 1];
+                col[keys[i].vtx] = cnt;
+            }
+        }
+        if (cnt == nr_colors || m_ticks > m_max_ticks) {
+            return true;
+        }
+        nr_colors = cnt;
+    }
+}
+
+int AutomorphismSearch::target_cell(const std::vector<int>& col,
+                                    std::vector<int>& cnt) const {
+    cnt.assign(*std::max_element(col.begin(), col.end()) + 1, 0);
+    for (int c : col) {
+        ++cnt[c];
+    }
+    int best = -1;
+    for (int c = 0; c < int(cnt.size()); ++c) {
+        if (cnt[c] > 1 && (best == -1 || cnt[c] < cnt[best])) {
+            best = c;
+        }
+    }
+    return best;
+}
+
+bool AutomorphismSearch::is_automorphism(const std::vector<int>& perm) {
+    for (int v = 0; v < m_g.size(); ++v) {
+        int pv = perm[v];
+        if (m_g.color[v] != m_g.color[pv] || m_g.degree(v) != m_g.degree(pv)) {
+            return false;
+        }
+        ++m_cur_stamp;
+        for (int i = 0, d = m_g.degree(pv); i < d; ++i) {
+            m_stamp[m_g.adj_of(pv)[i]] = m_cur_stamp;
+        }
+        for (int i = 0, d = m_g.degree(v); i < d; ++i) {
+            if (m_stamp[perm[m_g.adj_of(v)[i]]] != m_cur_stamp) {
+                return false;
+            }
+        }
+    }
+    m_ticks += m_g.adj.size();
+    return true;
+}
+
+bool AutomorphismSearch::complete_by_identity(const std::vector<int>& l,
+                                              const std::vector<int>& r,
+                                              const std::vector<int>& cnt,
+                                              std::vector<int>& perm) {
+    int n = m_g.size();
+    std::vector<int> vtx_of(cnt.size(), -1);
+    for (int v = 0; v < n; ++v) {
+        if (cnt[r[v]] == 1) {
+            vtx_of[r[v]] = v;
+        }
+    }
+    perm.resize(n);
+    for (int v = 0; v < n; ++v) {
+        if (cnt[l[v]] == 1) {
+            perm[v] = vtx_of[l[v]];
+        } else if (l[v] == r[v]) {
+            perm[v] = v;
+        } else {
+            return false;
+        }
+    }
+    return is_automorphism(perm);
+}
+
+bool AutomorphismSearch::search(const std::vector<int>& l,
+                                const std::vector<int>& r,
+                                std::vector<int>& perm) {
+    if (++m_nodes > MAX_SEARCH_NODES || m_ticks > m_max_ticks) {
+        return false;
+    }
+    std::vector<int> cnt;
+    int cell = target_cell(l, cnt), nr_colors = cnt.size();
+    if (complete_by_identity(l, r, cnt, perm)) {
+        return true;
+    }
+    if (cell == -1) {
+        return false;
+    }
+    int x = std::find(l.begin(), l.end(), cell) - l.begin();
+    std::vector<int> ys;
+    for (int v = 0; v < m_g.size(); ++v) {
+        if (r[v] == cell) {
+            ys.push_back(v);
+        }
+    }
+    // try to fix x first, which succeeds for most of the leaves
+    auto it = std::find(ys.begin(), ys.end(), x);
+    if (it != ys.end()) {
+        std::swap(*it, ys[0]);
+    }
+    for (int y : ys) {
+        std::vector<int> l1 = l, r1 = r;
+        l1[x] = r1[y] = nr_colors;
+        if (refine(l1, r1) && search(l1, r1, perm)) {
+            return true;
+        }
+        if (m_nodes > MAX_SEARCH_NODES || m_ticks > m_max_ticks) {
+            return false;
+        }
+    }
+    return false;
+}
+
+void AutomorphismSearch::run() {
+    int n = m_g.size();
+    std::vector<int> col = m_g.color, parent(n), perm, cnt;
+    refine(col);
+    auto find = [&parent](int v) {
+        while (parent[v] != v) {
+            v = parent[v] = parent[parent[v]];
+        }
+        return v;
+    };
+    while (m_ticks <= m_max_ticks) {
+        int cell = target_cell(col, cnt), nr_colors = cnt.size();
+        if (cell == -1) {
+            break;
+        }
+        // generators found at this level fix all the previous base points,
+        // so their orbits show the targets that need no search
+        std::iota(parent.begin(), parent.end(), 0);
+        int v = std::find(col.begin(), col.end(), cell) - col.begin();
+        for (int w = 0; w < n && m_ticks <= m_max_ticks; ++w) {
+            if (w == v || col[w] != cell || find(w) == find(v)) {
+                continue;
+            }
+            std::vector<int> l = col, r = col;
+            l[v] = r[w] = nr_colors;
+            m_nodes = 0;
+            if (refine(l, r) && search(l, r, perm)) {
+                generators.push_back(perm);
+                for (int u = 0; u < n; ++u) {
+                    parent[find(u)] = find(perm[u]);
+                }
+            }
+        }
+        col[v] = nr_colors;
+        refine(col);
+    }
+}
+}  // anonymous namespace
+
+bool Solver::break_symmetries() {
+    assert(decisionLevel() == 0);
+    // the XOR matrices are not part of the graph
+    if (!xors.empty()) {
+        return true;
+    }
+
+    // vertices 2i and 2i+1 are the lits of the i-th used var
+    std::vector<int> idx_of(nVars(), -1);
+    std::vector<Var> var_of;
+    auto add_var = [&](Lit p) {
+        if (idx_of[var(p)] == -1) {
+            idx_of[var(p)] = 0;
+            var_of.push_back(var(p));
+        }
+    };
+    for (CRef cr : clauses) {
+        const Clause& c = ca[cr];
+        for (int i = 0; i < c.size(); ++i) {
+            add_var(c[i]);
+        }
+        if (c.is_leq()) {
+            add_var(c.leq_dst());
+        }
+    }
+    if (var_of.empty()) {
+        return true;
+    }
+    std::sort(var_of.begin(), var_of.end());
+    for (int i = 0; i < int(var_of.size()); ++i) {
+        idx_of[var_of[i]] = i;
+    }
+    auto vtx_of = [&idx_of](Lit p) { return 2 * idx_of[var(p)] + sign(p); };
+
+    // colors: lits by root value, then clauses, dst vertices and LEQs
+    constexpr int COLOR_CLAUSE = 3, COLOR_DST = 4, COLOR_LEQ = 5;
+    ColoredGraph g;
+    std::vector<std::pair<int, int>> edges;
+    for (int i = 0; i < int(var_of.size()); ++i) {
+        lbool val = rootValue(mkLit(var_of[i]));
+        int c = val == l_Undef ? 0 : 1 + (val == l_False);
+        g.color.push_back(c);
+        g.color.push_back(val == l_Undef ? 0 : 3 - c);
+        edges.push_back({2 * i, 2 * i + 1});
+    }
+    for (CRef cr : clauses) {
+        const Clause& c = ca[cr];
+        int node = g.color.size();
+        g.color.push_back(c.is_leq() ? COLOR_LEQ + c.leq_bound()
+                                     : COLOR_CLAUSE);
+        for (int i = 0; i < c.size(); ++i) {
+            edges.push_back({node, vtx_of(c[i])});
+        }
+        if (c.is_leq()) {
+            g.color.push_back(COLOR_DST);
+            edges.push_back({node, node + 1});
+            edges.push_back({node + 1, vtx_of(c.leq_dst())});
+        }
+    }
+    int n = g.color.size();
+    g.adj_begin.assign(n + 1, 0);
+    for (auto [a, b] : edges) {
+        ++g.adj_begin[a + 1];
+        ++g.adj_begin[b + 1];
+    }
+    std::partial_sum(g.adj_begin.begin(), g.adj_begin.end(),
+                     g.adj_begin.begin());
+    g.adj.resize(edges.size() * 2);
+    {
+        std::vector<int> pos(g.adj_begin.begin(), g.adj_begin.end() - 1);
+        for (auto [a, b] : edges) {
+            g.adj[pos[a]++] = b;
+            g.adj[pos[b]++] = a;
+        }
+    }
+    edges.clear();
+    edges.shrink_to_fit();
+
+    AutomorphismSearch search{g, sym_ticks};
+    search.run();
+
+    vec<Lit> ps;
+    for (const std::vector<int>& perm : search.generators) {
+        auto image = [&](int i) {
+            int u = perm[2 * i];
+            return mkLit(var_of[u / 2], u & 1);
+        };
+        bool moves = false;
+        for (int i = 0; i < int(var_of.size()) && !moves; ++i) {
+            moves = perm[2 * i] != 2 * i;
+        }
+        if (!moves) {
+            continue;
+        }
+        ++sym_generators;
+
+        // x <=lex sigma(x) over the support: with e_0 true and e_i meaning
+        // that the first i vars equal their images, require
+        // e_{i-1} -> (x_i -> sigma(x_i)) and
+        // e_{i-1} & (x_i = sigma(x_i)) -> e_i
+        Lit eq = lit_Undef;
+        int nr_done = 0;
+        for (int i = 0; i < int(var_of.size()) && nr_done < sym_lex_size;
+             ++i) {
+            Lit x = mkLit(var_of[i]), y = image(i);
+            if (y == x) {
+                continue;
+            }
+            ++nr_done;
+            auto add = [&](std::initializer_list<Lit> lits) {
+                ps.clear();
+                if (eq != lit_Undef) {
+                    ps.push(~eq);
+                }
+                for (Lit p : lits) {
+                    ps.push(p);
+                }
+                ++sym_clauses;
+                return addClauseNoGuard_(ps, track_taint);
+            };
+            if (y == ~x) {
+                if (!add({~x})) {
+                    return false;
+                }
+                break;
+            }
+            if (!add({~x, y})) {
+                return false;
+            }
+            if (nr_done == sym_lex_size) {
+                break;
+            }
+            Lit next = mkLit(newVar());
+            if (!add({next, ~x}) || !add({next, y})) {
+                return false;
+            }
+            eq = next;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,440 @@
+/*****************************************************************************************[Xor.cc]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "minisat/core/Solver.h"
+#include "minisat/utils/System.h"
+
+#include <array>
+#include <numeric>
+
+using namespace Minisat;
+
+/*
+ * Propagation on a matrix in reduced row echelon form, after Han and Jiang,
+ * "When Boolean Satisfiability Meets Gaussian Elimination in a Simplex Way"
+ * (CAV 2012). Each row watches its basic column and one unassigned non-basic
+ * column. When the watched column is assigned, another unassigned non-basic
+ * column is watched; if there is none, the row implies its basic var. When
+ * the basic var is assigned, an unassigned non-basic column becomes basic by
+ * a pivot, which eliminates it from the other rows. Like two watched lits,
+ * nothing needs to be undone on backtracking: a row without unassigned
+ * non-basic columns watches the one assigned at the highest level.
+ *
+ * Reasons and conflicts are materialized as clauses over the vars of a row,
+ * with the implied lit first, so analyze() handles them like any clause.
+ * They are freed by cancelUntil() once the implied var is unassigned.
+ */
+
+bool Solver::addXor_(vec<Lit>& ps) {
+    if (!scopes.size()) {
+        return addXorNoGuard_(ps);
+    }
+    // the xor is assigned to a fresh var, whose value is guarded
+    Lit def = mkLit(newScopeVar(true));
+    ps.push(~def);
+    if (!addXorNoGuard_(ps)) {
+        return false;
+    }
+    return addClause(def);
+}
+
+bool Solver::addXorNoGuard_(vec<Lit>& ps, bool from_clauses) {
+    if (!ok) {
+        return false;
+    }
+    XorConstraint x{{}, true, from_clauses, constraint_taint(ps)};
+    for (Lit p : ps) {
+        minisat_uassert(var(p) < nVars(), "var=%d nVars=%d", var(p), nVars());
+        x.rhs ^= sign(p);
+        x.vars.push_back(var(p));
+    }
+    // a var that occurs twice cancels out
+    std::sort(x.vars.begin(), x.vars.end());
+    size_t j = 0;
+    for (size_t i = 0; i < x.vars.size(); ++i) {
+        if (i + 1 < x.vars.size() && x.vars[i] == x.vars[i + 1]) {
+            ++i;
+        } else {
+            x.vars[j++] = x.vars[i];
+        }
+    }
+    x.vars.resize(j);
+    added_constraints++;
+    if (x.vars.empty()) {
+        return ok = !x.rhs;
+    }
+    xors.push_back(std::move(x));
+    xors_dirty = true;
+    // the matrices are rebuilt by simplify()
+    cancelUntil(0);
+    return true;
+}
+
+void Solver::detect_xors() {
+    // an XOR of k vars is encoded by the 2^(k-1) clauses over them whose
+    // numbers of negative lits have the parity opposite to rhs
+    constexpr int MAX_SIZE = 6;
+    struct Entry {
+        std::array<Var, MAX_SIZE> vars;
+        int size;
+        //! bit i is the sign of the lit of vars[i]
+        int signs;
+        bool taint;
+    };
+    std::vector<Entry> entries;
+    std::array<Lit, MAX_SIZE> lits;
+    for (CRef cr : clauses) {
+        const Clause& c = ca[cr];
+        if (c.is_leq() || c.size() < 2 || c.size() > MAX_SIZE) {
+            continue;
+        }
+        for (int i = 0; i < c.size(); ++i) {
+            // insertion sort
+            int k = i;
+            for (; k && c[i] < lits[k - 1]; --k) {
+                lits[k] = lits[k - 1];
+            }
+            lits[k] = c[i];
+        }
+        Entry e{{}, c.size(), 0, c.tainted()};
+        bool distinct = true;
+        for (int i = 0; i < c.size(); ++i) {
+            e.vars[i] = var(lits[i]);
+            e.signs |= sign(lits[i]) << i;
+            distinct &= !i || e.vars[i] != e.vars[i - 1];
+        }
+        if (distinct) {
+            entries.push_back(e);
+        }
+    }
+    auto same_vars = [](const Entry& a, const Entry& b) {
+        return a.size == b.size &&
+               std::equal(a.vars.begin(), a.vars.begin() + a.size,
+                          b.vars.begin());
+    };
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) {
+                  if (a.size != b.size) {
+                      return a.size < b.size;
+                  }
+                  return std::lexicographical_compare(
+                          a.vars.begin(), a.vars.begin() + a.size,
+                          b.vars.begin(), b.vars.begin() + b.size);
+              });
+
+    vec<Lit> ps;
+    for (size_t i = 0, j; i < entries.size(); i = j) {
+        // distinct sign patterns by parity of the number of negative lits
+        uint64_t seen[2] = {0, 0};
+        bool taint = false;
+        for (j = i; j < entries.size() && same_vars(entries[i], entries[j]);
+             ++j) {
+            int s = entries[j].signs;
+            seen[__builtin_popcount(s) & 1] |= uint64_t(1) << s;
+            taint |= entries[j].taint;
+        }
+        const Entry& e = entries[i];
+        for (int parity = 0; parity < 2; ++parity) {
+            if (__builtin_popcountll(seen[parity]) != 1 << (e.size - 1)) {
+                continue;
+            }
+            ps.clear();
+            for (int k = 0; k < e.size; ++k) {
+                ps.push(mkLit(e.vars[k]));
+            }
+            // rhs = 1 - parity; a negated lit flips rhs
+            ps[0] = ps[0] ^ parity;
+            addXorNoGuard_(ps, true);
+            xors.back().taint |= taint;
+        }
+    }
+}
+
+bool Solver::gauss_setup() {
+    assert(decisionLevel() == 0);
+    xors_dirty = false;
+    xor_matrices.clear();
+    xor_col.assign(nVars(), {-1, -1});
+
+    // connected components of the unassigned vars
+    std::vector<Var> parent(nVars());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](Var v) {
+        while (parent[v] != v) {
+            v = parent[v] = parent[parent[v]];
+        }
+        return v;
+    };
+    std::vector<std::vector<Var>> rows;
+    std::vector<char> rows_rhs, rows_taint;
+    for (const XorConstraint& x : xors) {
+        std::vector<Var> vars;
+        bool rhs = x.rhs, taint = x.taint;
+        for (Var v : x.vars) {
+            if (value(v) == l_Undef) {
+                vars.push_back(v);
+                parent[find(v)] = find(vars[0]);
+            } else {
+                rhs ^= value(v) == l_True;
+                taint |= track_taint && root_taint[v];
+            }
+        }
+        if (vars.empty()) {
+            if (rhs) {
+                return false;
+            }
+            continue;
+        }
+        rows.push_back(std::move(vars));
+        rows_rhs.push_back(rhs);
+        rows_taint.push_back(taint);
+    }
+
+    std::vector<int> comp_of(nVars(), -1);
+    std::vector<std::vector<int>> comp_rows;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        Var root = find(rows[i][0]);
+        if (comp_of[root] == -1) {
+            comp_of[root] = comp_rows.size();
+            comp_rows.emplace_back();
+        }
+        comp_rows[comp_of[root]].push_back(i);
+    }
+
+    for (const std::vector<int>& rs : comp_rows) {
+        XorMatrix m;
+        int mi = xor_matrices.size();
+        for (int i : rs) {
+            for (Var v : rows[i]) {
+                if (xor_col[v].first == -1) {
+                    xor_col[v] = {mi, int(m.col_var.size())};
+                    m.col_var.push_back(v);
+                }
+            }
+        }
+        m.init(rs.size(), m.col_var.size());
+        for (size_t r = 0; r < rs.size(); ++r) {
+            for (Var v : rows[rs[r]]) {
+                m.set(r, xor_col[v].second);
+            }
+            m.rhs[r] = rows_rhs[rs[r]];
+            m.taint |= rows_taint[rs[r]];
+        }
+
+        // Gauss-Jordan elimination to reduced row echelon form
+        int rank = 0;
+        for (int c = 0; c < m.nr_cols() && rank < m.nr_rows(); ++c) {
+            int piv = rank;
+            while (piv < m.nr_rows() && !m.get(piv, c)) {
+                ++piv;
+            }
+            if (piv == m.nr_rows()) {
+                continue;
+            }
+            m.swap_rows(piv, rank);
+            for (int r = 0; r < m.nr_rows(); ++r) {
+                if (r != rank && m.get(r, c)) {
+                    m.xor_row(r, rank);
+                }
+            }
+            m.basic[rank] = c;
+            m.basic_row[c] = rank;
+            ++rank;
+        }
+        for (int r = rank; r < m.nr_rows(); ++r) {
+            if (m.rhs[r]) {
+                return false;
+            }
+        }
+        m.bits.resize(size_t(rank) * m.nr_words);
+        m.rhs.resize(rank);
+        m.basic.resize(rank);
+        m.watch.resize(rank);
+
+        for (int r = 0; r < rank; ++r) {
+            m.for_each_col(r, [&](int c) {
+                if (c != m.basic[r] && m.watch[r] == -1) {
+                    m.watch[r] = c;
+                    m.col_watches[c].push_back(r);
+                }
+            });
+        }
+        xor_matrices.push_back(std::move(m));
+    }
+
+    // rows without non-basic columns are units
+    for (XorMatrix& m : xor_matrices) {
+        for (int r = 0; r < m.nr_rows(); ++r) {
+            if (m.watch[r] == -1 && xor_unit(m, r) != CRef_Undef) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int Solver::xor_find_watch(const XorMatrix& m, int r) const {
+    const uint64_t* p = m.row(r);
+    int basic = m.basic[r];
+    for (int i = 0; i < m.nr_words; ++i) {
+        for (uint64_t w = p[i]; w; w &= w - 1) {
+            int c = i * 64 + __builtin_ctzll(w);
+            if (c != basic && value(m.col_var[c]) == l_Undef) {
+                return c;
+            }
+        }
+    }
+    return -1;
+}
+
+CRef Solver::xor_alloc(const XorMatrix& m, int r, Lit implied) {
+    xor_lits.clear();
+    if (implied != lit_Undef) {
+        xor_lits.push(implied);
+    }
+    m.for_each_col(r, [&](int c) {
+        Var x = m.col_var[c];
+        if (implied == lit_Undef || x != var(implied)) {
+            // the lit that is false under the current assignment
+            xor_lits.push(mkLit(x, value(x) == l_True));
+        }
+    });
+    CRef cr = ca.alloc(xor_lits, false);
+    ca[cr].tainted(m.taint);
+    xor_reasons.emplace_back(trail.size(), cr);
+    return cr;
+}
+
+CRef Solver::xor_unit(XorMatrix& m, int r) {
+    int basic = m.basic[r];
+    bool val = m.rhs[r];
+    m.for_each_col(r, [&](int c) {
+        if (c != basic) {
+            val ^= value(m.col_var[c]) == l_True;
+        }
+    });
+    Lit p = mkLit(m.col_var[basic], !val);
+    if (value(p) == l_True) {
+        return CRef_Undef;
+    }
+    if (value(p) == l_False) {
+        xor_conflicts++;
+        return xor_alloc(m, r, lit_Undef);
+    }
+    xor_propagations++;
+    if (decisionLevel() == 0) {
+        bool taint = m.taint;
+        if (track_taint) {
+            m.for_each_col(r, [&](int c) {
+                taint |= c != basic && root_taint[m.col_var[c]];
+            });
+        }
+        uncheckedEnqueue(p, CRef_Undef, taint);
+    } else {
+        uncheckedEnqueue(p, xor_alloc(m, r, p));
+    }
+    return CRef_Undef;
+}
+
+CRef Solver::xor_fix_row(XorMatrix& m, int r) {
+    int w = m.watch[r];
+    if (w == -1 || !m.get(r, w) || w == m.basic[r] ||
+        value(m.col_var[w]) != l_Undef) {
+        w = xor_find_watch(m, r);
+        if (w == -1) {
+            // watch the non-basic column assigned last
+            int lvl = -1;
+            m.for_each_col(r, [&](int c) {
+                if (c != m.basic[r] && level(m.col_var[c]) > lvl) {
+                    lvl = level(m.col_var[c]);
+                    w = c;
+                }
+            });
+        }
+        if (w != m.watch[r]) {
+            m.watch[r] = w;
+            if (w != -1) {
+                m.col_watches[w].push_back(r);
+            }
+        }
+        if (w == -1 || value(m.col_var[w]) != l_Undef) {
+            return xor_unit(m, r);
+        }
+    }
+    return CRef_Undef;
+}
+
+CRef Solver::propagate_xor(Lit p) {
+    Var v = var(p);
+    if (v >= int(xor_col.size()) || xor_col[v].first == -1) {
+        return CRef_Undef;
+    }
+    auto [mi, col] = xor_col[v];
+    XorMatrix& m = xor_matrices[mi];
+    CRef confl = CRef_Undef;
+
+    if (int r = m.basic_row[col]; r != -1) {
+        int y = xor_find_watch(m, r);
+        if (y == -1) {
+            confl = xor_unit(m, r);
+        } else {
+            // pivot: y becomes the basic column of r
+            m.basic[r] = y;
+            m.basic_row[y] = r;
+            m.basic_row[col] = -1;
+            xor_pivots++;
+            for (int r2 = 0; r2 < m.nr_rows(); ++r2) {
+                if (r2 != r && m.get(r2, y)) {
+                    m.xor_row(r2, r);
+                    CRef cr = xor_fix_row(m, r2);
+                    if (confl == CRef_Undef) {
+                        confl = cr;
+                    }
+                }
+            }
+            CRef cr = xor_fix_row(m, r);
+            if (confl == CRef_Undef) {
+                confl = cr;
+            }
+        }
+    }
+
+    std::vector<int>& ws = m.col_watches[col];
+    size_t i, j;
+    for (i = j = 0; i < ws.size(); ++i) {
+        int r = ws[i];
+        if (m.watch[r] != col) {
+            continue;
+        }
+        if (confl == CRef_Undef) {
+            int w = xor_find_watch(m, r);
+            if (w != -1) {
+                m.watch[r] = w;
+                m.col_watches[w].push_back(r);
+                continue;
+            }
+            confl = xor_unit(m, r);
+        }
+        ws[j++] = r;
+    }
+    ws.resize(j);
+    return confl;
+}
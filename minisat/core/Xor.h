@@ -0,0 +1,136 @@
+/******************************************************************************************[Xor.h]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#pragma once
+
+#include "minisat/core/SolverTypes.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace Minisat {
+
+//! an XOR constraint: the xor of the vars equals rhs
+struct XorConstraint {
+    std::vector<Var> vars;
+    bool rhs;
+    //! whether it was found in the clauses, which are kept
+    bool from_clauses;
+    bool taint;
+};
+
+/*!
+ * A system of XOR constraints over a connected set of vars, kept in reduced
+ * row echelon form: each row has a basic column that no other row contains.
+ * Row operations are equivalences, so the matrix stays valid across
+ * backtracking and is only changed by pivoting. Rows are bit-packed, padded
+ * to a multiple of 4 words for the SIMD row xor.
+ */
+struct XorMatrix {
+    static constexpr int WORD_ALIGN = 4;
+
+    int nr_words = 0;
+    //! row-major bits; bits[r * nr_words + c / 64] holds column c of row r
+    std::vector<uint64_t> bits;
+    std::vector<char> rhs;
+    std::vector<Var> col_var;
+    //! basic column of each row
+    std::vector<int> basic;
+    //! row of each basic column, or -1
+    std::vector<int> basic_row;
+    //! non-basic column watched by each row, or -1 if there is none
+    std::vector<int> watch;
+    //! rows that watched each column; entries are stale if the row has moved
+    //! its watch since
+    std::vector<std::vector<int>> col_watches;
+    bool taint = false;
+
+    int nr_rows() const { return rhs.size(); }
+    int nr_cols() const { return col_var.size(); }
+
+    uint64_t* row(int r) { return &bits[size_t(r) * nr_words]; }
+    const uint64_t* row(int r) const { return &bits[size_t(r) * nr_words]; }
+
+    bool get(int r, int c) const { return row(r)[c >> 6] >> (c & 63) & 1; }
+    void set(int r, int c) { row(r)[c >> 6] |= uint64_t(1) << (c & 63); }
+
+    void init(int nr_rows, int nr_cols) {
+        nr_words = (nr_cols + 63) / 64;
+        nr_words = (nr_words + WORD_ALIGN - 1) / WORD_ALIGN * WORD_ALIGN;
+        bits.assign(size_t(nr_rows) * nr_words, 0);
+        rhs.assign(nr_rows, 0);
+        basic.assign(nr_rows, -1);
+        watch.assign(nr_rows, -1);
+        basic_row.assign(nr_cols, -1);
+        col_watches.assign(nr_cols, {});
+    }
+
+    void swap_rows(int a, int b) {
+        std::swap_ranges(row(a), row(a) + nr_words, row(b));
+        std::swap(rhs[a], rhs[b]);
+    }
+
+    //! row @p dst ^= row @p src
+    void xor_row(int dst, int src) {
+        uint64_t* __restrict d = row(dst);
+        const uint64_t* __restrict s = row(src);
+#if defined(__AVX2__)
+        for (int i = 0; i < nr_words; i += 4) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<__m256i*>(d + i));
+            __m256i b = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(s + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i),
+                                _mm256_xor_si256(a, b));
+        }
+#elif defined(__SSE2__)
+        for (int i = 0; i < nr_words; i += 2) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<__m128i*>(d + i));
+            __m128i b =
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i),
+                             _mm_xor_si128(a, b));
+        }
+#else
+        for (int i = 0; i < nr_words; ++i) {
+            d[i] ^= s[i];
+        }
+#endif
+        rhs[dst] ^= rhs[src];
+    }
+
+    //! call @p fn with each column of row @p r
+    template <class Fn>
+    void for_each_col(int r, Fn&& fn) const {
+        const uint64_t* p = row(r);
+        for (int i = 0; i < nr_words; ++i) {
+            for (uint64_t w = p[i]; w; w &= w - 1) {
+                fn(i * 64 + __builtin_ctzll(w));
+            }
+        }
+    }
+};
+
+}  // namespace Minisat
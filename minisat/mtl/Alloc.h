@@ -57,17 +57,18 @@ public:
 
 
     uint32_t size      () const      { return sz; }
+    uint32_t capacity  () const      { return cap; }
     uint32_t wasted    () const      { return wasted_; }
 
-    Ref      alloc     (int size);
+    Ref      alloc     (uint32_t size);
     void     free      (int size)    { wasted_ += size; }
 
     // Deref, Load Effective Address (LEA), Inverse of LEA (AEL):
-    T&       operator[](Ref r)       { assert(r >= 0 && r < sz); return memory[r]; }
-    const T& operator[](Ref r) const { assert(r >= 0 && r < sz); return memory[r]; }
+    T&       operator[](Ref r)       { assert(r < sz); return memory[r]; }
+    const T& operator[](Ref r) const { assert(r < sz); return memory[r]; }
 
-    T*       lea       (Ref r)       { assert(r >= 0 && r < sz); return &memory[r]; }
-    const T* lea       (Ref r) const { assert(r >= 0 && r < sz); return &memory[r]; }
+    T*       lea       (Ref r)       { assert(r < sz); return &memory[r]; }
+    const T* lea       (Ref r) const { assert(r < sz); return &memory[r]; }
     Ref      ael       (const T* t)  { assert(t >= &memory[0] && t < &memory[sz]);
         return  static_cast<Ref>(t - &memory[0]); }
 
@@ -111,7 +112,7 @@ void RegionAllocator<T>::capacity(uint32_t min_cap)
 
 template<class T>
 typename RegionAllocator<T>::Ref
-RegionAllocator<T>::alloc(int size)
+RegionAllocator<T>::alloc(uint32_t size)
 {
     // printf("ALLOC called (this = %p, size = %d)\n", this, size); fflush(stdout);
     assert(size > 0);
@@ -107,6 +107,24 @@ class Heap {
     }
 
 
+    // Remove an arbitrary element from the heap:
+    void remove(int n)
+    {
+        assert(inHeap(n));
+        int i            = indices[n];
+        indices[n]       = -1;
+        if (i < heap.size() - 1){
+            int x      = heap.last();
+            heap[i]    = x;
+            indices[x] = i;
+            heap.pop();
+            percolateUp(i);
+            percolateDown(indices[x]);
+        }else
+            heap.pop();
+    }
+
+
     int  removeMin()
     {
         int x            = heap[0];
@@ -133,6 +151,31 @@ class Heap {
             percolateDown(i);
     }
 
+    // Same as 'build()', but each level of the heap is percolated by 'par_for(n, fn)', which
+    // calls 'fn(begin, end)' on ranges covering [0, n). The subtrees below one level are
+    // disjoint, so the result does not depend on how the ranges are split:
+    template<class ParFor>
+    void build(vec<int>& ns, ParFor&& par_for) {
+        for (int i = 0; i < heap.size(); i++)
+            indices[heap[i]] = -1;
+        heap.clear();
+
+        for (int i = 0; i < ns.size(); i++){
+            indices[ns[i]] = i;
+            heap.push(ns[i]); }
+
+        int first = 0;
+        while (first * 2 + 1 < heap.size() / 2)
+            first = first * 2 + 1;
+        for (; first >= 0; first = (first - 1) / 2){
+            int end = first * 2 + 1 < heap.size() / 2 ? first * 2 + 1 : heap.size() / 2;
+            par_for(size_t(end - first), [this, first](size_t b, size_t e){
+                for (size_t i = b; i < e; i++)
+                    percolateDown(first + int(i)); });
+            if (first == 0) break;
+        }
+    }
+
     void clear(bool dealloc = false) 
     { 
         for (int i = 0; i < heap.size(); i++)
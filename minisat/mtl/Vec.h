@@ -93,6 +93,8 @@ public:
     void growTo(int size);
     void growTo(int size, const T& pad);
     void clear(bool dealloc = false);
+    //! release unused capacity
+    void shrink_to_fit();
 
     // Stack interface:
     void push(void) {
@@ -193,6 +195,22 @@ void vec<T>::clear(bool dealloc) {
     }
 }
 
+template <class T>
+void vec<T>::shrink_to_fit() {
+    if (m_sz == 0) {
+        clear(true);
+        return;
+    }
+    int cap = (m_sz + 1) & ~1;  // keep capacities even (see push())
+    if (cap >= m_cap) {
+        return;
+    }
+    if (T* data = static_cast<T*>(::realloc(m_data, cap * sizeof(T)))) {
+        m_data = data;
+        m_cap = cap;
+    }
+}
+
 //=================================================================================================
 }  // namespace Minisat
 
@@ -0,0 +1,195 @@
+/***************************************************************************************[Client.cc]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+// minisat-client: submit problems to minisat-server and print the replies
+
+#include "minisat/server/Protocol.h"
+#include "minisat/utils/Options.h"
+
+#include <zlib.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Minisat;
+using namespace Minisat::server;
+
+namespace {
+
+//! read a plain or gzipped file; exit on error
+std::string read_file(const char* path) {
+    gzFile in = gzopen(path, "rb");
+    if (!in) {
+        fprintf(stderr, "ERROR! Could not open file: %s\n", path);
+        exit(1);
+    }
+    std::string data;
+    char buf[65536];
+    int n;
+    while ((n = gzread(in, buf, sizeof(buf))) > 0) {
+        data.append(buf, n);
+    }
+    gzclose(in);
+    if (n < 0) {
+        fprintf(stderr, "ERROR! Could not read file: %s\n", path);
+        exit(1);
+    }
+    if (!data.empty() && data.back() != '\n') {
+        data += '\n';
+    }
+    return data;
+}
+
+bool starts_with(const std::string& s, const char* prefix) {
+    return s.compare(0, strlen(prefix), prefix) == 0;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    setUsageHelp(
+            "USAGE: %s [options] <input-file> ...\n\n  Submit each input "
+            "file (plain or gzipped DIMACS) as a job to minisat-server.\n");
+
+    StringOption socket_path("MAIN", "socket", "Path of the server socket.",
+                             DEFAULT_SOCKET);
+    IntOption priority("MAIN", "priority", "Job priority (larger runs first).",
+                       0, IntRange(INT32_MIN, INT32_MAX));
+    Int64Option conflicts("MAIN", "conflicts",
+                          "Conflict budget per job (-1 = unlimited).", -1,
+                          Int64Range(-1, INT64_MAX));
+    Int64Option propagations("MAIN", "propagations",
+                             "Propagation budget per job (-1 = unlimited).", -1,
+                             Int64Range(-1, INT64_MAX));
+    DoubleOption timeout("MAIN", "timeout",
+                         "Wall clock budget per job in seconds (-1 = "
+                         "unlimited).",
+                         -1, DoubleRange(-1, true, HUGE_VAL, true));
+    StringOption base("MAIN", "base",
+                      "Solve the inputs as deltas on this cached base.");
+    StringOption define_base("MAIN", "define-base",
+                             "Upload the first input as a base with this name "
+                             "instead of solving it.");
+    BoolOption share("MAIN", "share",
+                     "Share learnt clauses of the jobs into the base.", false);
+    StringOption assume("MAIN", "assume",
+                        "Comma separated assumptions in DIMACS numbering.");
+    BoolOption stats("MAIN", "stats", "Print server statistics.", false);
+    BoolOption shutdown("MAIN", "shutdown", "Ask the server to exit.", false);
+
+    parseOptions(argc, argv, true);
+
+    sockaddr_un addr;
+    if (!make_socket_addr(addr, socket_path)) {
+        fprintf(stderr, "ERROR! Socket path too long: %s\n",
+                (const char*)socket_path);
+        exit(1);
+    }
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 ||
+        ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr))) {
+        fprintf(stderr, "ERROR! Could not connect to %s: %s\n",
+                (const char*)socket_path, strerror(errno));
+        exit(1);
+    }
+
+    // requests are sent by a separate thread so that replies are consumed
+    // while large inputs are still being sent
+    std::vector<std::string> requests;
+    if (define_base) {
+        if (argc < 2) {
+            fprintf(stderr, "ERROR! -define-base needs an input file\n");
+            exit(1);
+        }
+        requests.push_back(std::string{"base "} + (const char*)define_base +
+                           "\n" + read_file(argv[1]) + "end\n");
+    } else {
+        for (int i = 1; i < argc; ++i) {
+            std::string req = "solve " + std::to_string(i);
+            req += " priority=" + std::to_string(priority);
+            if (conflicts >= 0) {
+                req += " conflicts=" + std::to_string(conflicts);
+            }
+            if (propagations >= 0) {
+                req += " propagations=" + std::to_string(propagations);
+            }
+            if (timeout >= 0) {
+                req += " timeout=" + std::to_string(timeout);
+            }
+            if (base) {
+                req += std::string{" base="} + (const char*)base;
+            }
+            if (share) {
+                req += " share=1";
+            }
+            if (assume) {
+                req += std::string{" assume="} + (const char*)assume;
+            }
+            requests.push_back(req + "\n" + read_file(argv[i]) + "end\n");
+        }
+    }
+    if (stats) {
+        requests.push_back("stats\n");
+    }
+    if (shutdown) {
+        requests.push_back("shutdown\n");
+    }
+    // number of reply lines that end a request
+    int nr_pending = requests.size();
+    std::thread sender{[fd, &requests]() {
+        for (auto& i : requests) {
+            if (!send_all(fd, i)) {
+                break;
+            }
+        }
+    }};
+
+    int exit_code = 0;
+    LineReader reader{fd};
+    std::string line;
+    while (nr_pending && reader.read_line(line)) {
+        printf("%s\n", line.c_str());
+        if (starts_with(line, "result ")) {
+            if (argc == 2) {
+                exit_code = line.find(" UNSAT") != std::string::npos ? 20
+                            : line.find(" SAT") != std::string::npos ? 10
+                                                                      : 0;
+            }
+        } else if (starts_with(line, "stats ") || starts_with(line, "ok ") ||
+                   starts_with(line, "error ") ||
+                   starts_with(line, "server ")) {
+            --nr_pending;
+        }
+    }
+    ::shutdown(fd, SHUT_RDWR);
+    sender.join();
+    ::close(fd);
+    if (nr_pending) {
+        fprintf(stderr, "ERROR! Connection closed by the server\n");
+        exit(1);
+    }
+    return exit_code;
+}
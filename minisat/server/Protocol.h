@@ -0,0 +1,136 @@
+/*************************************************************************************[Protocol.h]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#pragma once
+
+// Line-based protocol of minisat-server over a Unix stream socket. A client
+// may pipeline any number of requests; replies of different jobs can be
+// interleaved and arrive in completion order.
+//
+// Requests:
+//
+//  base <name>
+//  <extended DIMACS>
+//  end
+//      Parse and cache a base problem under <name>, replacing any previous
+//      one. Reply: "ok base <name> vars=<n>" or "error <msg>".
+//
+//  solve <id> [key=value ...]
+//  <extended DIMACS>
+//  end
+//      Queue a job. Keys:
+//          priority=<int>      larger runs first (default 0)
+//          conflicts=<int>     conflict budget
+//          propagations=<int>  propagation budget
+//          timeout=<seconds>   wall clock budget
+//          base=<name>         start from a cached base; the body is a delta
+//          share=1             add learnt clauses that only depend on the base
+//                              back to the cached base for later jobs
+//          assume=<lit>,...    assumptions in DIMACS numbering
+//      Replies: "queued <id>" once the job is accepted, then
+//      "result <id> SAT|UNSAT|INDET", "model <id> <lits> 0" if SAT, and
+//      "stats <id> key=value ...". A job that can not be run, including
+//      one beyond the -max-vars or -job-mem limits of the server, gets
+//      "error <id> <msg>" instead of the result lines.
+//
+//  stats
+//      Reply: "server key=value ..." with queue and worker counters.
+//
+//  shutdown
+//      Reply: "ok shutdown"; running jobs are interrupted and the server
+//      exits.
+//
+// A body line consisting of "end" terminates the body; everything else is
+// passed to parse_DIMACS().
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+
+namespace Minisat {
+namespace server {
+
+constexpr const char* DEFAULT_SOCKET = "/tmp/minisat-server.sock";
+
+//! fill a sockaddr_un; return false if @p path is too long
+inline bool make_socket_addr(sockaddr_un& addr, const char* path) {
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    strcpy(addr.sun_path, path);
+    return true;
+}
+
+//! write all data to a socket; return false on error
+inline bool send_all(int fd, const char* data, size_t size) {
+    while (size) {
+        ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+inline bool send_all(int fd, const std::string& data) {
+    return send_all(fd, data.data(), data.size());
+}
+
+//! buffered reader that splits a socket stream into lines
+class LineReader {
+    int m_fd;
+    std::string m_buf;
+    size_t m_pos = 0;
+
+public:
+    explicit LineReader(int fd) : m_fd{fd} {}
+
+    //! read the next line without the trailing newline; return false on EOF
+    //! or error
+    bool read_line(std::string& line) {
+        for (;;) {
+            size_t end = m_buf.find('\n', m_pos);
+            if (end != std::string::npos) {
+                line.assign(m_buf, m_pos, end - m_pos);
+                m_pos = end + 1;
+                return true;
+            }
+            m_buf.erase(0, m_pos);
+            m_pos = 0;
+            char tmp[65536];
+            ssize_t n = ::recv(m_fd, tmp, sizeof(tmp), 0);
+            if (n <= 0) {
+                return false;
+            }
+            m_buf.append(tmp, n);
+        }
+    }
+};
+
+}  // namespace server
+}  // namespace Minisat
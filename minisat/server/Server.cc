@@ -0,0 +1,670 @@
+/***************************************************************************************[Server.cc]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+// minisat-server: solve problems submitted over a Unix domain socket on a
+// pool of solver threads; see Protocol.h for the wire format.
+
+#include "minisat/core/Dimacs.h"
+#include "minisat/core/Recorder.h"
+#include "minisat/core/Solver.h"
+#include "minisat/mtl/XAlloc.h"
+#include "minisat/server/Protocol.h"
+#include "minisat/utils/Options.h"
+#include "minisat/utils/ParseUtils.h"
+#include "minisat/utils/System.h"
+
+#include <signal.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace Minisat;
+using namespace Minisat::server;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point t) {
+    return std::chrono::duration<double>(Clock::now() - t).count();
+}
+
+//! parse target that records the constraints of a base problem
+class RecordingSink {
+    int m_nr_var = 0;
+
+public:
+    ClauseRecorder recorder;
+    //! required by parse_DIMACS(); names are not kept
+    std::unordered_map<int, std::string> var_names;
+
+    Var newVar() { return m_nr_var++; }
+    int nVars() const { return m_nr_var; }
+
+    bool addClause_(vec<Lit>& ps) {
+        recorder.add_disjuction(ps);
+        return true;
+    }
+    bool addLeqAssign_(vec<Lit>& ps, int bound, Lit dst) {
+        recorder.add_leq_assign(ps, bound, dst);
+        return true;
+    }
+    bool addGeqAssign_(vec<Lit>& ps, int bound, Lit dst) {
+        recorder.add_geq_assign(ps, bound, dst);
+        return true;
+    }
+    void setVarPreference(Var v, int p) {
+        minisat_uassert(v < m_nr_var, "var=%d nVars=%d", v, m_nr_var);
+        recorder.add_var_preference(v, p);
+    }
+};
+
+//! parse target that forwards to @p T and rejects variables beyond a limit,
+//! so that a short request can not allocate arbitrarily many variables
+template <class T>
+class VarLimitSink {
+    T& m_target;
+    const int m_max_vars;
+
+public:
+    std::unordered_map<int, std::string>& var_names;
+
+    VarLimitSink(T& target, int max_vars)
+            : m_target{target},
+              m_max_vars{max_vars},
+              var_names{target.var_names} {}
+
+    Var newVar() {
+        minisat_uassert(m_target.nVars() < m_max_vars,
+                        "too many variables (max-vars=%d)", m_max_vars);
+        return m_target.newVar();
+    }
+    int nVars() const { return m_target.nVars(); }
+
+    bool addClause_(vec<Lit>& ps) { return m_target.addClause_(ps); }
+    bool addLeqAssign_(vec<Lit>& ps, int bound, Lit dst) {
+        return m_target.addLeqAssign_(ps, bound, dst);
+    }
+    bool addGeqAssign_(vec<Lit>& ps, int bound, Lit dst) {
+        return m_target.addGeqAssign_(ps, bound, dst);
+    }
+    void setVarPreference(Var v, int p) {
+        minisat_uassert(v >= 0, "invalid var %d", v);
+        m_target.setVarPreference(v, p);
+    }
+};
+
+//! a cached base problem with a pool of learnt clauses shared by its jobs
+struct Base {
+    ClauseRecorder recorder;
+    std::mutex learnt_mtx;
+    std::vector<vec<Lit>> learnts;
+};
+
+class Connection {
+    int m_fd;
+    std::mutex m_mtx;
+
+public:
+    //! set when the client has gone away; its jobs are dropped
+    std::atomic<bool> closed{false};
+
+    explicit Connection(int fd) : m_fd{fd} {}
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+    ~Connection() { ::close(m_fd); }
+
+    int fd() const { return m_fd; }
+
+    void send(const std::string& msg) {
+        std::lock_guard<std::mutex> lock{m_mtx};
+        if (!closed && !send_all(m_fd, msg)) {
+            closed = true;
+        }
+    }
+};
+
+struct Job {
+    std::string id;
+    int priority = 0;
+    uint64_t seq = 0;
+    int64_t conflicts = -1, propagations = -1;
+    double timeout = -1;
+    std::shared_ptr<Base> base;
+    bool share = false;
+    std::vector<int> assume;
+    std::string body;
+    std::shared_ptr<Connection> conn;
+    Clock::time_point queued_at;
+};
+
+//! order of the job queue: higher priority first, then FIFO
+struct JobOrder {
+    bool operator()(const std::shared_ptr<Job>& a,
+                    const std::shared_ptr<Job>& b) const {
+        if (a->priority != b->priority) {
+            return a->priority < b->priority;
+        }
+        return a->seq > b->seq;
+    }
+};
+
+class Server {
+    struct Worker {
+        std::thread thread;
+        //! protects the fields below, which are read by the monitor
+        std::mutex mtx;
+        Solver* solver = nullptr;
+        bool has_deadline = false;
+        Clock::time_point deadline;
+        std::shared_ptr<Connection> conn;
+    };
+
+    const int m_share_max_lbd, m_share_max_size, m_share_max_nr;
+    //! per-job limits on the number of vars and on the memory footprint in
+    //! megabytes (0 for no memory limit)
+    const int m_max_vars, m_job_mem;
+
+    std::mutex m_mtx;
+    //! signals new jobs to the workers
+    std::condition_variable m_cv;
+    //! wakes up the monitor on shutdown
+    std::condition_variable m_monitor_cv;
+    std::priority_queue<std::shared_ptr<Job>, std::vector<std::shared_ptr<Job>>,
+                        JobOrder>
+            m_queue;
+    std::map<std::string, std::shared_ptr<Base>> m_bases;
+    uint64_t m_seq = 0, m_nr_done = 0, m_nr_dropped = 0;
+    int m_nr_running = 0;
+    bool m_stop = false;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::thread m_monitor;
+    int m_listen_fd = -1;
+
+    void worker_loop(Worker& worker);
+    void run_job(Worker& worker, Job& job);
+    void monitor_loop();
+    void serve_connection(std::shared_ptr<Connection> conn);
+
+    //! read a request body up to the "end" line
+    static bool read_body(LineReader& reader, std::string& body);
+    void define_base(Connection& conn, const std::string& name,
+                     const std::string& body);
+    void submit(const std::shared_ptr<Connection>& conn, std::istream& args,
+                std::string body);
+    std::string stats_line();
+
+public:
+    Server(int share_max_lbd, int share_max_size, int share_max_nr,
+           int max_vars, int job_mem)
+            : m_share_max_lbd{share_max_lbd},
+              m_share_max_size{share_max_size},
+              m_share_max_nr{share_max_nr},
+              m_max_vars{max_vars},
+              m_job_mem{job_mem} {}
+
+    //! listen on @p path and serve until a shutdown request; return exit code
+    int run(const char* path, int nr_threads);
+};
+
+void Server::worker_loop(Worker& worker) {
+    for (;;) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock{m_mtx};
+            m_cv.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+            if (m_stop) {
+                return;
+            }
+            job = m_queue.top();
+            m_queue.pop();
+            if (job->conn->closed) {
+                ++m_nr_dropped;
+                continue;
+            }
+            ++m_nr_running;
+        }
+        run_job(worker, *job);
+        std::lock_guard<std::mutex> lock{m_mtx};
+        --m_nr_running;
+        ++m_nr_done;
+    }
+}
+
+void Server::run_job(Worker& worker, Job& job) {
+    double wait_time = seconds_since(job.queued_at);
+    Clock::time_point start = Clock::now();
+
+    Solver S;
+    S.verbosity = 0;
+    vec<Lit> assumps;
+    try {
+        if (job.base) {
+            if (job.share) {
+                S.set_base_learnt_export(m_share_max_lbd, m_share_max_size);
+            }
+            job.base->recorder.replay(S);
+            {
+                std::lock_guard<std::mutex> lock{job.base->learnt_mtx};
+                vec<Lit> tmp;
+                for (const vec<Lit>& i : job.base->learnts) {
+                    i.copyTo(tmp);
+                    S.import_learnt(tmp);
+                }
+            }
+            if (job.share) {
+                S.set_adding_base(false);
+            }
+        }
+        VarLimitSink<Solver> sink{S, m_max_vars};
+        MemoryBuffer in{job.body.data(), job.body.size()};
+        parse_DIMACS_main(in, sink);
+        for (int i : job.assume) {
+            minisat_uassert(i != 0 && i != INT32_MIN, "invalid assumption %d",
+                            i);
+            Var v = std::abs(i) - 1;
+            while (v >= S.nVars()) {
+                sink.newVar();
+            }
+            assumps.push(mkLit(v, i < 0));
+        }
+        minisat_uassert(
+                !m_job_mem || S.mem_footprint() <= m_job_mem * 1048576.0,
+                "memory limit exceeded (job-mem=%d)", m_job_mem);
+    } catch (std::exception& exc) {
+        job.conn->send("error " + job.id + " " + exc.what() + "\n");
+        return;
+    } catch (OutOfMemoryException&) {
+        job.conn->send("error " + job.id + " out of memory\n");
+        return;
+    } catch (...) {
+        job.conn->send("error " + job.id + " unknown error\n");
+        return;
+    }
+    std::string().swap(job.body);
+    double parse_time = seconds_since(start);
+
+    // learnts are reduced to keep the job within its memory limit
+    S.mem_target = m_job_mem;
+
+    if (job.conflicts >= 0) {
+        S.setConfBudget(job.conflicts);
+    }
+    if (job.propagations >= 0) {
+        S.setPropBudget(job.propagations);
+    }
+    {
+        std::lock_guard<std::mutex> lock{worker.mtx};
+        worker.solver = &S;
+        worker.conn = job.conn;
+        worker.has_deadline = job.timeout >= 0;
+        if (worker.has_deadline) {
+            worker.deadline =
+                    start + std::chrono::duration_cast<Clock::duration>(
+                                    std::chrono::duration<double>(job.timeout));
+        }
+    }
+    lbool ret;
+    std::string error;
+    try {
+        ret = S.solveLimited(assumps);
+    } catch (std::exception& exc) {
+        error = exc.what();
+    } catch (OutOfMemoryException&) {
+        error = "out of memory";
+    } catch (...) {
+        error = "unknown error";
+    }
+    {
+        std::lock_guard<std::mutex> lock{worker.mtx};
+        worker.solver = nullptr;
+        worker.conn.reset();
+    }
+    if (!error.empty()) {
+        job.conn->send("error " + job.id + " " + error + "\n");
+        return;
+    }
+    double solve_time = seconds_since(start) - parse_time;
+
+    int nr_shared = 0;
+    if (job.share && !S.base_learnts.empty()) {
+        std::lock_guard<std::mutex> lock{job.base->learnt_mtx};
+        auto& pool = job.base->learnts;
+        for (auto& i : S.base_learnts) {
+            if (static_cast<int>(pool.size()) >= m_share_max_nr) {
+                break;
+            }
+            pool.emplace_back(std::move(i));
+            ++nr_shared;
+        }
+    }
+
+    std::ostringstream msg;
+    msg << "result " << job.id << " "
+        << (ret == l_True ? "SAT" : ret == l_False ? "UNSAT" : "INDET")
+        << "\n";
+    if (ret == l_True) {
+        msg << "model " << job.id;
+        for (int i = 0; i < S.model.size(); ++i) {
+            if (S.model[i] != l_Undef) {
+                msg << " " << (S.model[i] == l_True ? i + 1 : -i - 1);
+            }
+        }
+        msg << " 0\n";
+    }
+    char times[128];
+    snprintf(times, sizeof(times),
+             " wait_time=%.3f parse_time=%.3f solve_time=%.3f", wait_time,
+             parse_time, solve_time);
+    msg << "stats " << job.id << " vars=" << S.nVars()
+        << " clauses=" << S.nClauses() << " conflicts=" << S.conflicts
+        << " decisions=" << S.decisions
+        << " propagations=" << S.propagations << " shared=" << nr_shared
+        << times << "\n";
+    job.conn->send(msg.str());
+}
+
+void Server::monitor_loop() {
+    std::unique_lock<std::mutex> lock{m_mtx};
+    while (!m_stop) {
+        m_monitor_cv.wait_for(lock, std::chrono::milliseconds(20));
+        Clock::time_point now = Clock::now();
+        for (auto& i : m_workers) {
+            std::lock_guard<std::mutex> wlock{i->mtx};
+            if (i->solver && ((i->has_deadline && now >= i->deadline) ||
+                              i->conn->closed || m_stop)) {
+                i->solver->interrupt();
+            }
+        }
+    }
+}
+
+bool Server::read_body(LineReader& reader, std::string& body) {
+    std::string line;
+    body.clear();
+    while (reader.read_line(line)) {
+        if (line == "end") {
+            return true;
+        }
+        body += line;
+        body += '\n';
+    }
+    return false;
+}
+
+void Server::define_base(Connection& conn, const std::string& name,
+                         const std::string& body) {
+    auto sink = std::make_unique<RecordingSink>();
+    try {
+        VarLimitSink<RecordingSink> limited{*sink, m_max_vars};
+        MemoryBuffer in{body.data(), body.size()};
+        parse_DIMACS_main(in, limited);
+    } catch (std::exception& exc) {
+        conn.send("error " + name + " " + exc.what() + "\n");
+        return;
+    } catch (OutOfMemoryException&) {
+        conn.send("error " + name + " out of memory\n");
+        return;
+    }
+    auto base = std::make_shared<Base>();
+    base->recorder = std::move(sink->recorder);
+    int nr_var = base->recorder.nr_var();
+    {
+        std::lock_guard<std::mutex> lock{m_mtx};
+        m_bases[name] = std::move(base);
+    }
+    conn.send("ok base " + name + " vars=" + std::to_string(nr_var) + "\n");
+}
+
+void Server::submit(const std::shared_ptr<Connection>& conn,
+                    std::istream& args, std::string body) {
+    auto job = std::make_shared<Job>();
+    if (!(args >> job->id)) {
+        conn->send("error - missing job id\n");
+        return;
+    }
+    std::string kv, base_name;
+    try {
+        while (args >> kv) {
+            size_t eq = kv.find('=');
+            minisat_uassert(eq != std::string::npos, "bad argument: %s",
+                            kv.c_str());
+            std::string key = kv.substr(0, eq), val = kv.substr(eq + 1);
+            if (key == "priority") {
+                job->priority = std::stoi(val);
+            } else if (key == "conflicts") {
+                job->conflicts = std::stoll(val);
+            } else if (key == "propagations") {
+                job->propagations = std::stoll(val);
+            } else if (key == "timeout") {
+                job->timeout = std::stod(val);
+            } else if (key == "base") {
+                base_name = val;
+            } else if (key == "share") {
+                job->share = std::stoi(val) != 0;
+            } else if (key == "assume") {
+                std::istringstream lits{val};
+                std::string lit;
+                while (std::getline(lits, lit, ',')) {
+                    job->assume.push_back(std::stoi(lit));
+                }
+            } else {
+                minisat_uassert(false, "unknown key: %s", key.c_str());
+            }
+        }
+        minisat_uassert(!job->share || !base_name.empty(),
+                        "share=1 requires a base");
+    } catch (std::exception& exc) {
+        conn->send("error " + job->id + " " + exc.what() + "\n");
+        return;
+    }
+
+    job->body = std::move(body);
+    job->conn = conn;
+    job->queued_at = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock{m_mtx};
+        if (!base_name.empty()) {
+            auto iter = m_bases.find(base_name);
+            if (iter == m_bases.end()) {
+                conn->send("error " + job->id + " unknown base: " + base_name +
+                           "\n");
+                return;
+            }
+            job->base = iter->second;
+        }
+        job->seq = m_seq++;
+        // reply before any worker can send the result
+        conn->send("queued " + job->id + "\n");
+        m_queue.push(std::move(job));
+    }
+    m_cv.notify_one();
+}
+
+std::string Server::stats_line() {
+    std::lock_guard<std::mutex> lock{m_mtx};
+    std::ostringstream msg;
+    msg << "server workers=" << m_workers.size()
+        << " queued=" << m_queue.size() << " running=" << m_nr_running
+        << " done=" << m_nr_done << " dropped=" << m_nr_dropped
+        << " bases=" << m_bases.size() << "\n";
+    return msg.str();
+}
+
+void Server::serve_connection(std::shared_ptr<Connection> conn) {
+    LineReader reader{conn->fd()};
+    std::string line, cmd, arg, body;
+    while (reader.read_line(line)) {
+        std::istringstream args{line};
+        if (!(args >> cmd)) {
+            continue;
+        }
+        if (cmd == "base" || cmd == "solve") {
+            if (!read_body(reader, body)) {
+                break;
+            }
+            if (cmd == "solve") {
+                submit(conn, args, std::move(body));
+            } else if (args >> arg) {
+                define_base(*conn, arg, body);
+            } else {
+                conn->send("error - missing base name\n");
+            }
+        } else if (cmd == "stats") {
+            conn->send(stats_line());
+        } else if (cmd == "shutdown") {
+            conn->send("ok shutdown\n");
+            {
+                std::lock_guard<std::mutex> lock{m_mtx};
+                m_stop = true;
+            }
+            m_cv.notify_all();
+            m_monitor_cv.notify_all();
+            // wake up accept()
+            ::shutdown(m_listen_fd, SHUT_RDWR);
+            break;
+        } else {
+            conn->send("error - unknown command: " + cmd + "\n");
+        }
+    }
+    conn->closed = true;
+}
+
+int Server::run(const char* path, int nr_threads) {
+    sockaddr_un addr;
+    if (!make_socket_addr(addr, path)) {
+        fprintf(stderr, "ERROR! Socket path too long: %s\n", path);
+        return 1;
+    }
+    m_listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ::unlink(path);
+    if (m_listen_fd < 0 ||
+        ::bind(m_listen_fd, reinterpret_cast<sockaddr*>(&addr),
+               sizeof(addr)) ||
+        ::listen(m_listen_fd, 64)) {
+        fprintf(stderr, "ERROR! Could not listen on %s: %s\n", path,
+                strerror(errno));
+        return 1;
+    }
+
+    for (int i = 0; i < nr_threads; ++i) {
+        m_workers.emplace_back(new Worker);
+    }
+    for (auto& i : m_workers) {
+        Worker* worker = i.get();
+        worker->thread = std::thread{[this, worker]() { worker_loop(*worker); }};
+    }
+    m_monitor = std::thread{[this]() { monitor_loop(); }};
+    printf("minisat-server: listening on %s with %d workers\n", path,
+           nr_threads);
+    fflush(stdout);
+
+    for (;;) {
+        int fd = ::accept(m_listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            std::lock_guard<std::mutex> lock{m_mtx};
+            if (m_stop) {
+                break;
+            }
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            fprintf(stderr, "ERROR! accept: %s\n", strerror(errno));
+            m_stop = true;
+            break;
+        }
+        auto conn = std::make_shared<Connection>(fd);
+        std::thread{[this, conn]() { serve_connection(conn); }}.detach();
+    }
+
+    m_cv.notify_all();
+    m_monitor_cv.notify_all();
+    for (auto& i : m_workers) {
+        i->thread.join();
+    }
+    m_monitor.join();
+    ::close(m_listen_fd);
+    ::unlink(path);
+    return 0;
+}
+
+}  // anonymous namespace
+
+//=================================================================================================
+// Main:
+
+int main(int argc, char** argv) {
+    setUsageHelp(
+            "USAGE: %s [options]\n\n  Serve solve requests on a Unix domain "
+            "socket; see minisat/server/Protocol.h.\n");
+
+    StringOption socket_path("MAIN", "socket", "Path of the Unix domain socket.",
+                             DEFAULT_SOCKET);
+    IntOption threads("MAIN", "threads",
+                      "Number of solver threads (0 = number of CPUs).", 0,
+                      IntRange(0, 1024));
+    IntOption share_lbd("MAIN", "share-lbd",
+                        "Max LBD of learnt clauses shared into a base.", 8,
+                        IntRange(1, INT32_MAX));
+    IntOption share_size("MAIN", "share-size",
+                         "Max size of learnt clauses shared into a base.", 30,
+                         IntRange(1, INT32_MAX));
+    IntOption share_max("MAIN", "share-max",
+                        "Max number of learnt clauses kept per base.", 100000,
+                        IntRange(0, INT32_MAX));
+    IntOption max_vars("MAIN", "max-vars",
+                       "Max number of variables of a job or a base.", 1 << 22,
+                       IntRange(1, INT32_MAX));
+    IntOption job_mem("MAIN", "job-mem",
+                      "Memory limit of a job in megabytes; learnts are "
+                      "reduced to stay below it (0 = unlimited).",
+                      4096, IntRange(0, INT32_MAX));
+
+    parseOptions(argc, argv, true);
+
+    int nr_threads = threads;
+    if (!nr_threads) {
+        nr_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+    }
+
+    // malformed requests must not terminate the server
+    parse_error_throws = true;
+    signal(SIGPIPE, SIG_IGN);
+
+    // the server is never destroyed since detached connection threads may
+    // still be blocked on their sockets when it returns
+    Server* server = new Server{share_lbd, share_size, share_max, max_vars,
+                                job_mem};
+    exit(server->run(socket_path, nr_threads));
+}
@@ -125,7 +125,12 @@ int main(int argc, char** argv)
                 rl.rlim_cur = new_mem_lim;
                 if (setrlimit(RLIMIT_AS, &rl) == -1)
                     printf("WARNING! Could not set resource limit: Virtual memory.\n");
-            } }
+            }
+            // Degrade gracefully before the hard limit is hit; note that garbage collection
+            // temporarily holds two clause regions:
+            if (S.mem_target == 0)
+                S.mem_target = mem_lim / 2;
+        }
 
         if (argc == 1)
             printf("Reading from standard input... Use '--help' for help.\n");
@@ -23,6 +23,11 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "minisat/utils/System.h"
 #include "minisat/utils/Options.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
 using namespace Minisat;
 
 //=================================================================================================
@@ -37,9 +42,43 @@ static BoolOption   opt_use_elim         (_cat, "elim",         "Perform variabl
 static IntOption    opt_grow             (_cat, "grow",         "Allow a variable elimination step to grow by a number of clauses.", 0);
 static IntOption    opt_clause_lim       (_cat, "cl-lim",       "Variables are not eliminated if it produces a resolvent with a length above this limit. -1 means no limit", 20,   IntRange(-1, INT32_MAX));
 static IntOption    opt_subsumption_lim  (_cat, "sub-lim",      "Do not check if subsumption against a clause larger than this. -1 means no limit.", 1000, IntRange(-1, INT32_MAX));
+static IntOption    opt_simp_threads     (_cat, "simp-threads", "Number of threads for subsumption and variable elimination.", 1, IntRange(1, 256));
 static DoubleOption opt_simp_garbage_frac(_cat, "simp-gc-frac", "The fraction of wasted memory allowed before a garbage collection is triggered during simplification.",  0.5, DoubleRange(0, false, HUGE_VAL, false));
 
 
+// Parallel rounds are only used for at least this many queued clauses or candidate variables; the
+// limits are fixed so that the outcome does not depend on the number of threads:
+static const int par_min_subsumption = 256;
+static const int par_elim_batch      = 1024;
+
+
+// Call 'fn(i)' for all 0 <= i < n on up to 'nthreads' threads. 'fn' may only read shared state
+// and write to the output slot of item 'i'. Items are handed out in small chunks since their
+// costs vary a lot.
+template<class F>
+static void parallelFor(int n, int nthreads, const F& fn)
+{
+    const int chunk = 16;
+    nthreads = std::min(nthreads, (n + chunk - 1) / chunk);
+    if (nthreads <= 1){
+        for (int i = 0; i < n; i++) fn(i);
+        return; }
+
+    std::atomic<int> next(0);
+    auto work = [&](){
+        for (int b; (b = next.fetch_add(chunk, std::memory_order_relaxed)) < n;)
+            for (int i = b, e = std::min(b + chunk, n); i < e; i++)
+                fn(i); };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < nthreads; t++)
+        threads.emplace_back(work);
+    work();
+    for (auto& t : threads)
+        t.join();
+}
+
+
 //=================================================================================================
 // Constructor/Destructor:
 
@@ -52,6 +91,7 @@ SimpSolver::SimpSolver() :
   , use_asymm          (opt_use_asymm)
   , use_rcheck         (opt_use_rcheck)
   , use_elim           (opt_use_elim)
+  , simp_threads       (opt_simp_threads)
   , merges             (0)
   , asymm_lits         (0)
   , eliminated_vars    (0)
@@ -100,6 +140,9 @@ lbool SimpSolver::solve_(bool do_simp, bool turn_off_simp)
     do_simp &= use_simplification;
 
     if (do_simp){
+        // Elimination works on the top level only (see 'reuse_trail'):
+        cancelUntil(0);
+
         // Assumptions must be temporarily frozen to run variable elimination:
         for (int i = 0; i < assumptions.size(); i++){
             Var v = var(assumptions[i]);
@@ -249,10 +292,8 @@ bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& ou
 
 
 // Returns FALSE if clause is always satisfied.
-bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, int& size)
+static bool resolventSize(const Clause& _ps, const Clause& _qs, Var v, int& size)
 {
-    merges++;
-
     bool  ps_smallest = _ps.size() < _qs.size();
     const Clause& ps  =  ps_smallest ? _qs : _ps;
     const Clause& qs  =  ps_smallest ? _ps : _qs;
@@ -280,6 +321,14 @@ bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, int& size)
 }
 
 
+// Returns FALSE if clause is always satisfied.
+bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, int& size)
+{
+    merges++;
+    return resolventSize(_ps, _qs, v, size);
+}
+
+
 void SimpSolver::gatherTouchedClauses()
 {
     if (n_touched == 0) return;
@@ -344,6 +393,11 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
             bwdsub_assigns = trail.size();
             break; }
 
+        if (simp_threads > 1 && subsumption_queue.size() >= par_min_subsumption){
+            if (!parallelSubsumption(subsumed, deleted_literals))
+                return false;
+            continue; }
+
         // Check top-level assignments by creating a dummy clause and placing it in the queue:
         if (subsumption_queue.size() == 0 && bwdsub_assigns < trail.size()){
             Lit l = trail[bwdsub_assigns++];
@@ -396,6 +450,60 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
 }
 
 
+// One round of 'backwardSubsumptionCheck()' over the whole queue: the candidates of every queued
+// clause are collected concurrently, then applied in queue order. Candidates are checked again
+// when applied since earlier clauses of the round may have removed or strengthened them (a
+// strengthened clause goes back to the queue, so nothing is missed).
+bool SimpSolver::parallelSubsumption(int& subsumed, int& deleted_literals)
+{
+    vec<CRef> batch;
+    while (subsumption_queue.size() > 0){
+        CRef cr = subsumption_queue.peek(); subsumption_queue.pop();
+        if (!ca[cr].mark())
+            batch.push(cr); }
+
+    // Occurrence lists are only read below, so they must not need lazy cleaning:
+    occurs.cleanAll();
+
+    std::vector<std::vector<CRef>> found(batch.size());
+    parallelFor(batch.size(), simp_threads, [&](int i){
+        const Clause& c = ca[batch[i]];
+
+        Var best = var(c[0]);
+        for (int k = 1; k < c.size(); k++)
+            if (occurs[var(c[k])].size() < occurs[best].size())
+                best = var(c[k]);
+
+        const vec<CRef>& cs = occurs[best];
+        for (int j = 0; j < cs.size(); j++)
+            if (cs[j] != batch[i] && (subsumption_lim == -1 || ca[cs[j]].size() < subsumption_lim) &&
+                c.subsumes(ca[cs[j]]) != lit_Error)
+                found[i].push_back(cs[j]);
+    });
+
+    for (int i = 0; i < batch.size(); i++){
+        const Clause& c = ca[batch[i]];
+        for (CRef d : found[i]){
+            if (c.mark())
+                break;
+            if (ca[d].mark())
+                continue;
+
+            Lit l = c.subsumes(ca[d]);
+            if (l == lit_Undef)
+                subsumed++, removeClause(d);
+            else if (l != lit_Error){
+                deleted_literals++;
+                if (!strengthenClause(d, ~l))
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
 bool SimpSolver::asymm(Var v, CRef cr)
 {
     Clause& c = ca[cr];
@@ -479,24 +587,51 @@ bool SimpSolver::eliminateVar(Var v)
     assert(!isEliminated(v));
     assert(value(v) == l_Undef);
 
-    // Split the occurrences into positive and negative:
-    //
-    const vec<CRef>& cls = occurs.lookup(v);
+    occurs.lookup(v);
+    int  nmerges = 0;
+    bool elim    = checkElim(v, nmerges);
+    merges += nmerges;
+
+    return !elim || (commitElim(v) && backwardSubsumptionCheck());
+}
+
+
+// Check wether the increase in number of clauses stays within the allowed ('grow'). Moreover, no
+// clause must exceed the limit on the maximal clause size (if it is set). Only reads the clause
+// database and requires a clean occurrence list of 'v', so it may run concurrently for several
+// variables:
+bool SimpSolver::checkElim(Var v, int& nmerges)
+{
+    const vec<CRef>& cls = occurs[v];
     vec<CRef>        pos, neg;
     for (int i = 0; i < cls.size(); i++)
         (find(ca[cls[i]], mkLit(v)) ? pos : neg).push(cls[i]);
 
-    // Check wether the increase in number of clauses stays within the allowed ('grow'). Moreover, no
-    // clause must exceed the limit on the maximal clause size (if it is set):
-    //
     int cnt         = 0;
     int clause_size = 0;
 
     for (int i = 0; i < pos.size(); i++)
-        for (int j = 0; j < neg.size(); j++)
-            if (merge(ca[pos[i]], ca[neg[j]], v, clause_size) &&
+        for (int j = 0; j < neg.size(); j++){
+            nmerges++;
+            if (resolventSize(ca[pos[i]], ca[neg[j]], v, clause_size) &&
                 (++cnt > cls.size() + grow || (clause_lim != -1 && clause_size > clause_lim)))
-                return true;
+                return false;
+        }
+
+    return true;
+}
+
+
+// Replace the clauses of 'v' by their resolvents. Does not run backward subsumption on the
+// resolvents:
+bool SimpSolver::commitElim(Var v)
+{
+    // Split the occurrences into positive and negative:
+    //
+    const vec<CRef>& cls = occurs.lookup(v);
+    vec<CRef>        pos, neg;
+    for (int i = 0; i < cls.size(); i++)
+        (find(ca[cls[i]], mkLit(v)) ? pos : neg).push(cls[i]);
 
     // Delete and store old clauses:
     eliminated[v] = true;
@@ -530,7 +665,70 @@ bool SimpSolver::eliminateVar(Var v)
     if (watches[ mkLit(v)].size() == 0) watches[ mkLit(v)].clear(true);
     if (watches[~mkLit(v)].size() == 0) watches[~mkLit(v)].clear(true);
 
-    return backwardSubsumptionCheck();
+    return true;
+}
+
+
+// Variable elimination in rounds: a batch of variables that pairwise share no clause is taken
+// from 'elim_heap', the elimination checks of the batch run concurrently, and the eliminations
+// are committed in heap order. Committing one variable of the batch can not change the clauses of
+// another one, so the checks stay valid. Variables skipped because they share a clause with the
+// batch go back to the heap.
+bool SimpSolver::parallelEliminate()
+{
+    vec<char> locked(nVars(), 0);
+    vec<Var>  locked_vars, batch, postponed;
+
+    while (!elim_heap.empty() && !asynch_interrupt){
+        while (!elim_heap.empty() && batch.size() + postponed.size() < par_elim_batch){
+            Var v = elim_heap.removeMin();
+            if (isEliminated(v) || value(v) != l_Undef || frozen[v])
+                continue;
+            if (locked[v]){
+                postponed.push(v);
+                continue; }
+
+            const vec<CRef>& cls = occurs.lookup(v);
+            for (int i = 0; i < cls.size(); i++){
+                const Clause& c = ca[cls[i]];
+                for (int j = 0; j < c.size(); j++)
+                    if (!locked[var(c[j])]){
+                        locked[var(c[j])] = 1;
+                        locked_vars.push(var(c[j])); }
+            }
+            batch.push(v);
+        }
+
+        if (verbosity >= 2)
+            printf("elimination left: %10d\r", elim_heap.size());
+
+        std::vector<char> elim(batch.size());
+        std::vector<int>  nmerges(batch.size());
+        parallelFor(batch.size(), simp_threads, [&](int i){
+            elim[i] = checkElim(batch[i], nmerges[i]); });
+
+        for (int i = 0; i < batch.size(); i++){
+            merges += nmerges[i];
+            // A unit resolvent of an earlier variable may have assigned this one:
+            if (elim[i] && value(batch[i]) == l_Undef && !asynch_interrupt && !commitElim(batch[i]))
+                return false;
+        }
+
+        for (int i = 0; i < locked_vars.size(); i++)
+            locked[locked_vars[i]] = 0;
+        for (int i = 0; i < postponed.size(); i++)
+            if (!elim_heap.inHeap(postponed[i]))
+                elim_heap.insert(postponed[i]);
+        locked_vars.clear();
+        batch.clear();
+        postponed.clear();
+
+        if (!backwardSubsumptionCheck())
+            return false;
+        checkGarbage(simp_garbage_frac);
+    }
+
+    return true;
 }
 
 
@@ -609,6 +807,9 @@ bool SimpSolver::eliminate(bool turn_off_elim)
             goto cleanup; }
 
         // printf("  ## (time = %6.2f s) ELIM: vars = %d\n", cpuTime(), elim_heap.size());
+        if (simp_threads > 1 && use_elim && !use_asymm && !parallelEliminate()){
+            ok = false; goto cleanup; }
+
         for (int cnt = 0; !elim_heap.empty(); cnt++){
             Var elim = elim_heap.removeMin();
 
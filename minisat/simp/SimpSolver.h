@@ -89,6 +89,8 @@ class SimpSolver : public Solver {
     bool    use_asymm;         // Shrink clauses by asymmetric branching.
     bool    use_rcheck;        // Check if a clause is already implied. Prett costly, and subsumes subsumptions :)
     bool    use_elim;          // Perform variable elimination.
+    int     simp_threads;      // Threads for subsumption and variable elimination. With more than one thread,
+                               // work is done in rounds whose result does not depend on the thread count.
 
     // Statistics:
     //
@@ -152,6 +154,10 @@ class SimpSolver : public Solver {
     bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, int& size);
     bool          backwardSubsumptionCheck (bool verbose = false);
     bool          eliminateVar             (Var v);
+    bool          checkElim                (Var v, int& nmerges);
+    bool          commitElim               (Var v);
+    bool          parallelSubsumption      (int& subsumed, int& deleted_literals);
+    bool          parallelEliminate        ();
     void          extendModel              ();
 
     void          removeClause             (CRef cr);
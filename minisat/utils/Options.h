@@ -52,6 +52,7 @@ class Option
     const char* description;
     const char* category;
     const char* type_name;
+    bool        given;
 
     static vec<Option*>& getOptionList () { static vec<Option*> options; return options; }
     static const char*&  getUsageString() { static const char* usage_str; return usage_str; }
@@ -72,6 +73,7 @@ class Option
     , description(desc_)
     , category   (cate_)
     , type_name  (type_)
+    , given      (false)
     {
         getOptionList().push(this);
     }
@@ -79,6 +81,9 @@ class Option
  public:
     virtual ~Option() {}
 
+    // Whether the option has been set on the command line by 'parseOptions()':
+    bool isGiven() const { return given; }
+
     virtual bool parse             (const char* str)      = 0;
     virtual void help              (bool verbose = false) = 0;
 
@@ -0,0 +1,113 @@
+/*********************************************************************************[OutputBuffer.h]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zlib.h>
+
+namespace Minisat {
+
+//! buffered writer to a plain or gzip-compressed file; the counterpart of
+//! StreamBuffer
+class OutputBuffer {
+    static constexpr int SIZE = 1 << 20;
+
+    FILE* m_file = nullptr;
+    gzFile m_gz = nullptr;
+    bool m_ok = true;
+    int m_pos = 0;
+    char m_buf[SIZE];
+
+public:
+    //! the file is not closed by the buffer
+    explicit OutputBuffer(FILE* file) : m_file{file} {}
+    explicit OutputBuffer(gzFile file) : m_gz{file} {}
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    ~OutputBuffer() { flush(); }
+
+    //! whether all data have been written successfully so far
+    bool ok() const { return m_ok; }
+
+    //! write buffered data to the file; return ok()
+    bool flush() {
+        if (m_pos && m_ok) {
+            if (m_file) {
+                m_ok = fwrite(m_buf, 1, m_pos, m_file) ==
+                       static_cast<size_t>(m_pos);
+            } else {
+                m_ok = gzwrite(m_gz, m_buf, m_pos) == m_pos;
+            }
+        }
+        m_pos = 0;
+        return m_ok;
+    }
+
+    void put(char c) {
+        if (m_pos == SIZE) {
+            flush();
+        }
+        m_buf[m_pos++] = c;
+    }
+
+    void put(const char* s) {
+        for (size_t len = strlen(s); len;) {
+            if (m_pos == SIZE) {
+                flush();
+            }
+            size_t n = SIZE - m_pos;
+            if (n > len) {
+                n = len;
+            }
+            memcpy(m_buf + m_pos, s, n);
+            m_pos += n;
+            s += n;
+            len -= n;
+        }
+    }
+
+    //! write a decimal integer
+    void put_int(long long v) {
+        char tmp[24];
+        int len = 0;
+        unsigned long long u = v;
+        if (v < 0) {
+            put('-');
+            u = -u;
+        }
+        do {
+            tmp[len++] = '0' + u % 10;
+            u /= 10;
+        } while (u);
+        if (SIZE - m_pos < len) {
+            flush();
+        }
+        while (len) {
+            m_buf[m_pos++] = tmp[--len];
+        }
+    }
+};
+
+}  // namespace Minisat
@@ -24,6 +24,9 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <stdlib.h>
 #include <stdio.h>
 
+#include <stdexcept>
+#include <string>
+
 #include <zlib.h>
 
 namespace Minisat {
@@ -54,11 +57,48 @@ public:
 };
 
 
+//-------------------------------------------------------------------------------------------------
+// A character stream over a block of memory that is not copied:
+
+class MemoryBuffer {
+    const char* buf;
+    size_t      pos;
+    size_t      size;
+
+public:
+    MemoryBuffer(const char* b, size_t s) : buf(b), pos(0), size(s) {}
+
+    int  operator *  () const { return (pos >= size) ? EOF : (unsigned char)buf[pos]; }
+    void operator ++ ()       { pos++; }
+    int  position    () const { return (int)pos; }
+};
+
+
+//-------------------------------------------------------------------------------------------------
+// Parse errors terminate the process with exit code 3, unless 'parse_error_throws' is set by a
+// long-running process (such as minisat-server), which then gets a 'ParseError':
+
+class ParseError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+inline bool parse_error_throws = false;
+
+[[noreturn]] static inline void parseError(const char* msg, int c) {
+    if (parse_error_throws) {
+        char c_str[2] = {(char)c, 0};
+        throw ParseError(std::string("PARSE ERROR! ") + msg + ": " + (c == EOF ? "<EOF>" : c_str)); }
+    fprintf(stderr, "PARSE ERROR! %s: %c\n", msg, c);
+    exit(3); }
+
+
 //-------------------------------------------------------------------------------------------------
 // End-of-file detection functions for StreamBuffer and char*:
 
 
 static inline bool isEof(StreamBuffer& in) { return *in == EOF;  }
+static inline bool isEof(MemoryBuffer& in) { return *in == EOF;  }
 static inline bool isEof(const char*   in) { return *in == '\0'; }
 
 //-------------------------------------------------------------------------------------------------
@@ -86,7 +126,7 @@ static int parseInt(B& in) {
     skipWhitespace(in);
     if      (*in == '-') neg = true, ++in;
     else if (*in == '+') ++in;
-    if (*in < '0' || *in > '9') fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", *in), exit(3);
+    if (*in < '0' || *in > '9') parseError("Unexpected char", *in);
     while (*in >= '0' && *in <= '9')
         val = val*10 + (*in - '0'),
         ++in;
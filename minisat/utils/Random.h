@@ -50,6 +50,9 @@ public:
         m_state = (static_cast<__uint128_t>(rng()) << 64) | rng();
     }
 
+    //! 64 uniform random bits
+    uint64_t bits() { return next(); }
+
     //! a uniform real in [0, 1)
     double uniform() { return next() / DMAX; }
 
@@ -0,0 +1,144 @@
+/***********************************************************************************[ThreadPool.h]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Minisat {
+
+/*!
+ * a fixed set of helper threads for splitting loops of stop-the-world phases
+ *
+ * The calling thread takes part in the work, so a pool without helpers runs
+ * everything inline. Only one loop can run at a time.
+ */
+class ThreadPool {
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_cv_start, m_cv_done;
+    uint64_t m_generation = 0;
+    int m_nr_running = 0;
+    bool m_stop = false;
+
+    const std::function<void(size_t, size_t)>* m_fn = nullptr;
+    size_t m_size = 0, m_chunk = 0;
+    std::atomic<size_t> m_next{0};
+
+    void run_chunks() {
+        for (;;) {
+            size_t begin = m_next.fetch_add(m_chunk);
+            if (begin >= m_size) {
+                return;
+            }
+            (*m_fn)(begin, std::min(begin + m_chunk, m_size));
+        }
+    }
+
+    void worker() {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock{m_mutex};
+                m_cv_start.wait(lock, [&]() {
+                    return m_stop || m_generation != seen;
+                });
+                if (m_stop) {
+                    return;
+                }
+                seen = m_generation;
+            }
+            run_chunks();
+            std::lock_guard<std::mutex> lock{m_mutex};
+            if (!--m_nr_running) {
+                m_cv_done.notify_one();
+            }
+        }
+    }
+
+public:
+    explicit ThreadPool(int nr_helpers) {
+        for (int i = 0; i < nr_helpers; ++i) {
+            m_threads.emplace_back([this]() { worker(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_stop = true;
+        }
+        m_cv_start.notify_all();
+        for (auto& i : m_threads) {
+            i.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int nr_helpers() const { return m_threads.size(); }
+
+    /*!
+     * call fn(begin, end) on disjoint ranges that cover [0, n) and return
+     * after all the calls have finished
+     *
+     * \param grain minimal number of items in a range; smaller loops run
+     *      inline
+     */
+    template <typename Fn>
+    void parallel_for(size_t n, size_t grain, Fn&& fn) {
+        if (m_threads.empty() || n <= grain) {
+            if (n) {
+                fn(size_t(0), n);
+            }
+            return;
+        }
+        // a few ranges per thread to balance uneven items
+        size_t nr_ranges = (m_threads.size() + 1) * 4;
+        std::function<void(size_t, size_t)> f{std::ref(fn)};
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_fn = &f;
+            m_size = n;
+            m_chunk = std::max(grain, (n + nr_ranges - 1) / nr_ranges);
+            m_next = 0;
+            m_nr_running = m_threads.size();
+            ++m_generation;
+        }
+        m_cv_start.notify_all();
+        run_chunks();
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_cv_done.wait(lock, [this]() { return !m_nr_running; });
+        m_fn = nullptr;
+    }
+};
+
+}  // namespace Minisat
@@ -1,13 +1,18 @@
 #include "minisat/core/Recorder.h"
+#include "minisat/core/Scheduler.h"
 #include "minisat/core/Solver.h"
 
 #include <signal.h>
 
 #include <algorithm>
+#include <chrono>
 #include <condition_variable>
 #include <cstring>
 #include <functional>
+#include <mutex>
+#include <stdexcept>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 class MinisatClauseRecorder : public Minisat::ClauseRecorder {
@@ -31,6 +36,7 @@ class WrappedMinisatSolver : public Minisat::Solver {
     };
 
     class Timer;
+    friend class WrappedSolveScheduler;
 
     int m_new_clause_max_var = 0;
 
@@ -49,11 +55,33 @@ class WrappedMinisatSolver : public Minisat::Solver {
         return Minisat::mkLit(lv - 1, lit < 0);
     }
 
+    //! constraints are in the base set iff they are recorded; the base set
+    //! only matters with a recorder or learnt export, and marking constraints
+    //! as non-base otherwise would enable taint tracking for nothing
+    void update_adding_base() {
+        if (m_recorder || export_max_size) {
+            set_adding_base(m_recorder && !nScopes());
+        } else {
+            set_adding_base(true);
+        }
+    }
+
 public:
+    //! set the recorder of the base problem; constraints added inside a scope
+    //! (see push()) are temporary and therefore not recorded
     void set_recorder(MinisatClauseRecorder* recorder) {
         m_recorder = recorder;
     }
 
+    //! move learnt clauses that only depend on recorded constraints into the
+    //! recorder (see set_base_learnt_export())
+    void export_base_learnts(MinisatClauseRecorder* recorder) {
+        for (auto&& i : base_learnts) {
+            recorder->add_learnt(i);
+        }
+        base_learnts.clear();
+    }
+
     void new_clause_prepare() {
         m_new_clause_max_var = 0;
         add_tmp.clear();
@@ -63,7 +91,8 @@ public:
 
     void new_clause_commit() {
         add_vars();
-        if (m_recorder) {
+        update_adding_base();
+        if (m_recorder && !nScopes()) {
             m_recorder->add_disjuction(add_tmp);
         }
         addClause_(add_tmp);
@@ -73,7 +102,8 @@ public:
     void new_clause_commit_leq(int bound, int dst) {
         auto dstl = make_lit(dst);
         add_vars();
-        if (m_recorder) {
+        update_adding_base();
+        if (m_recorder && !nScopes()) {
             m_recorder->add_leq_assign(add_tmp, bound, dstl);
         }
         addLeqAssign_(add_tmp, bound, dstl);
@@ -83,7 +113,8 @@ public:
     void new_clause_commit_geq(int bound, int dst) {
         auto dstl = make_lit(dst);
         add_vars();
-        if (m_recorder) {
+        update_adding_base();
+        if (m_recorder && !nScopes()) {
             m_recorder->add_geq_assign(add_tmp, bound, dstl);
         }
         addGeqAssign_(add_tmp, bound, dstl);
@@ -210,3 +241,84 @@ int WrappedMinisatSolver::solve_with_signal(bool setup, double timeout) {
     throw std::runtime_error("computation interrupted");
 }
 
+
+//! id-based interface of Minisat::SolveScheduler for bindings without futures
+class WrappedSolveScheduler {
+    Minisat::SolveScheduler m_scheduler;
+    std::mutex m_mtx;
+    std::unordered_map<int, Minisat::SolveScheduler::Ticket> m_tickets;
+    int m_next_id = 0;
+
+    Minisat::SolveScheduler::Ticket find(int id) {
+        std::lock_guard<std::mutex> lg{m_mtx};
+        auto iter = m_tickets.find(id);
+        if (iter == m_tickets.end()) {
+            throw std::runtime_error("unknown solve job id");
+        }
+        return iter->second;
+    }
+
+public:
+    //! use earliest-deadline-first if @p by_deadline is set, and priorities
+    //! otherwise; see Minisat::SolveScheduler
+    WrappedSolveScheduler(int nr_threads, int slice_propagations,
+                          bool by_deadline)
+            : m_scheduler{nr_threads, slice_propagations,
+                          by_deadline
+                                  ? Minisat::SolveScheduler::Policy::DEADLINE
+                                  : Minisat::SolveScheduler::Policy::PRIORITY} {
+    }
+
+    //! solve @p solver under @p assumps asynchronously and return the job
+    //! id; the solver must not be used until the job is done. The job is
+    //! given up after @p timeout seconds unless it is negative.
+    int submit(WrappedMinisatSolver* solver, const std::vector<int>& assumps,
+               int priority, double timeout) {
+        Minisat::vec<Minisat::Lit> ps;
+        for (int i : assumps) {
+            ps.push(solver->make_lit(i));
+        }
+        solver->add_vars();
+        using Clock = Minisat::SolveScheduler::Clock;
+        auto deadline = Clock::time_point::max();
+        if (timeout >= 0) {
+            // timeouts beyond the range of the clock mean no deadline
+            auto now = Clock::now();
+            std::chrono::duration<double> left = deadline - now;
+            if (timeout < left.count()) {
+                deadline = now + std::chrono::duration_cast<Clock::duration>(
+                                         std::chrono::duration<double>{
+                                                 timeout});
+            }
+        }
+        auto ticket = m_scheduler.submit(*solver, ps, priority, deadline);
+        std::lock_guard<std::mutex> lg{m_mtx};
+        m_tickets.emplace(m_next_id, std::move(ticket));
+        return m_next_id++;
+    }
+
+    //! wait for a job for at most @p timeout seconds, or until it is done if
+    //! @p timeout is negative; return -2 if it is still pending, -1 if it has
+    //! been canceled or given up, 0 for unsat and 1 for sat. The id is
+    //! released once the result has been returned.
+    int wait(int id, double timeout) {
+        auto ticket = find(id);
+        if (timeout >= 0 &&
+            ticket.result.wait_for(std::chrono::duration<double>{timeout}) !=
+                    std::future_status::ready) {
+            return -2;
+        }
+        auto ret = ticket.result.get();
+        {
+            std::lock_guard<std::mutex> lg{m_mtx};
+            m_tickets.erase(id);
+        }
+        return ret.is_not_undef() ? ret.as_bool() : -1;
+    }
+
+    //! cancel a job; its result is still to be taken by wait()
+    void cancel(int id) { m_scheduler.cancel(find(id)); }
+
+    //! number of jobs that are queued or running
+    int nr_pending() { return m_scheduler.nr_pending(); }
+};
@@ -0,0 +1,490 @@
+/*************************************************************************************[ApiTest.cc]
+Copyright (c) 2020-2020, Kai Jia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+// minisat-api-test: check incremental use of the solver API against fresh
+// solvers on the instances of a list file
+
+#include "minisat/core/Dimacs.h"
+#include "minisat/core/Scheduler.h"
+#include "minisat/core/Solver.h"
+#include "minisat/utils/Options.h"
+#include "minisat/utils/ParseUtils.h"
+
+#include <zlib.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Minisat;
+
+namespace {
+
+//! read a plain or gzipped file; exit on error
+std::string read_file(const std::string& path) {
+    gzFile in = gzopen(path.c_str(), "rb");
+    if (!in) {
+        fprintf(stderr, "ERROR! Could not open file: %s\n", path.c_str());
+        exit(1);
+    }
+    std::string data;
+    char buf[65536];
+    int n;
+    while ((n = gzread(in, buf, sizeof(buf))) > 0) {
+        data.append(buf, n);
+    }
+    gzclose(in);
+    return data;
+}
+
+struct Instance {
+    std::string name, text;
+    //! expected answer without assumptions, from the path
+    bool sat;
+};
+
+void load(Solver& S, const Instance& inst) {
+    MemoryBuffer in{inst.text.data(), inst.text.size()};
+    parse_DIMACS_main(in, S);
+}
+
+//! dst = (sum(lits) <= bound)
+struct Leq {
+    vec<Lit> lits;
+    int bound;
+    Lit dst;
+};
+
+//! answer of a fresh solver on the instance with @p extra clauses and
+//! @p leqs added
+bool reference(const Instance& inst, const std::vector<vec<Lit>>& extra,
+               const std::vector<Leq>& leqs = {}) {
+    Solver S;
+    S.verbosity = 0;
+    load(S, inst);
+    for (const vec<Lit>& i : extra) {
+        S.addClause(i);
+    }
+    for (const Leq& i : leqs) {
+        vec<Lit> lits;
+        i.lits.copyTo(lits);
+        S.addLeqAssign_(lits, i.bound, i.dst);
+    }
+    return S.solve();
+}
+
+//! a solver that calls a function from on_model_candidate()
+class CallbackSolver : public Solver {
+public:
+    std::function<void()> on_candidate;
+
+protected:
+    void on_model_candidate() override { on_candidate(); }
+};
+
+class Checker {
+    std::mt19937 m_rng;
+    const Instance& m_inst;
+    int m_nr_var = 0;
+    int m_nr_error = 0;
+
+    Lit random_lit() {
+        return mkLit(m_rng() % m_nr_var, m_rng() % 2);
+    }
+
+    //! @p assumps are empty or the units in @p extra
+    void check(const char* what, Solver& S, bool ret, const vec<Lit>& assumps,
+               const std::vector<vec<Lit>>& extra,
+               const std::vector<Leq>& leqs = {}) {
+        bool expect = reference(m_inst, extra, leqs);
+        if (ret != expect) {
+            fprintf(stderr, "%s: %s: expect %s, got %s\n", m_inst.name.c_str(),
+                    what, expect ? "SAT" : "UNSAT", ret ? "SAT" : "UNSAT");
+            ++m_nr_error;
+            return;
+        }
+        if (ret) {
+            for (Lit i : assumps) {
+                if (S.modelValue(i) == l_False) {
+                    fprintf(stderr, "%s: %s: model violates assumption %s%d\n",
+                            m_inst.name.c_str(), what, sign(i) ? "-" : "",
+                            var(i) + 1);
+                    ++m_nr_error;
+                    return;
+                }
+            }
+            // the defined part of a (possibly partial) model must extend to
+            // a model of the instance and the extra clauses
+            std::vector<vec<Lit>> fixed(extra.size());
+            for (size_t i = 0; i < extra.size(); ++i) {
+                extra[i].copyTo(fixed[i]);
+            }
+            for (int i = 0; i < m_nr_var; ++i) {
+                lbool val = S.modelValue(i);
+                if (val != l_Undef) {
+                    fixed.emplace_back();
+                    fixed.back().push(mkLit(i, val == l_False));
+                }
+            }
+            if (!reference(m_inst, fixed, leqs)) {
+                fprintf(stderr, "%s: %s: model does not extend to a model\n",
+                        m_inst.name.c_str(), what);
+                ++m_nr_error;
+            }
+        }
+    }
+
+    //! assumption sequences that extend, shorten or repeat the previous one;
+    //! there is always an assumption, since a solve() without assumptions
+    //! may remove dead vars unless the solver is incremental
+    void run_assume(Solver& S) {
+        vec<Lit> assumps;
+        std::vector<vec<Lit>> units;
+        for (int q = 0; q < 8; ++q) {
+            int op = m_rng() % 4;
+            if (op == 0 && assumps.size() > 1) {
+                assumps.shrink(1 + m_rng() % (assumps.size() - 1));
+            } else if (op != 3 || !assumps.size()) {
+                assumps.push(random_lit());
+            }
+            units.clear();
+            for (Lit i : assumps) {
+                units.emplace_back();
+                units.back().push(i);
+            }
+            bool ret = S.solve(assumps);
+            check("assume", S, ret, assumps, units);
+            if (q == 4 && ret) {
+                // a new var adds no constraint, so a cached model stored
+                // before it existed may answer the repeated query
+                S.newVar();
+                if (!S.solve(assumps) || S.model.size() != S.nVars()) {
+                    fprintf(stderr, "%s: assume: no model after newVar()\n",
+                            m_inst.name.c_str());
+                    ++m_nr_error;
+                }
+            }
+        }
+    }
+
+    //! add random clauses between solve() calls
+    void run_add(Solver& S) {
+        std::vector<vec<Lit>> added;
+        vec<Lit> none;
+        for (int q = 0; q < 6; ++q) {
+            added.emplace_back();
+            for (int i = 1 + m_rng() % 3; i; --i) {
+                added.back().push(random_lit());
+            }
+            vec<Lit> tmp;
+            added.back().copyTo(tmp);
+            S.addClause(tmp);
+            check("add", S, S.solve(), none, added);
+        }
+    }
+
+    //! add @p nr random clauses to @p S and @p added
+    void add_random_clauses(Solver& S, std::vector<vec<Lit>>& added, int nr) {
+        for (; nr; --nr) {
+            vec<Lit> ps;
+            for (int i = 1 + m_rng() % 3; i; --i) {
+                ps.push(random_lit());
+            }
+            added.emplace_back();
+            ps.copyTo(added.back());
+            S.addClause(ps);
+        }
+    }
+
+    //! random clauses in nested scopes that are popped again
+    void run_scope(Solver& S) {
+        vec<Lit> none;
+        for (int round = 0; round < 2; ++round) {
+            std::vector<vec<Lit>> outer, inner;
+            S.push();
+            add_random_clauses(S, outer, 2);
+            check("scope outer", S, S.solve(), none, outer);
+            for (int j = 0; j < 2; ++j) {
+                S.push();
+                inner.clear();
+                for (const vec<Lit>& i : outer) {
+                    inner.emplace_back();
+                    i.copyTo(inner.back());
+                }
+                add_random_clauses(S, inner, 1 + j);
+                check("scope inner", S, S.solve(), none, inner);
+                S.pop();
+                check("scope popped", S, S.solve(), none, outer);
+            }
+            S.pop();
+            outer.clear();
+            check("scope base", S, S.solve(), none, outer);
+        }
+    }
+
+    //! learnts exported from a solver with extra non-base clauses must be
+    //! implied by the base alone
+    void run_taint(Solver& S) {
+        vec<Lit> none;
+        std::vector<vec<Lit>> extra;
+        S.set_adding_base(false);
+        add_random_clauses(S, extra, 3);
+        check("taint export", S, S.solve(), none, extra);
+        for (int round = 0; round < 2; ++round) {
+            Solver S2;
+            S2.verbosity = 0;
+            load(S2, m_inst);
+            for (const vec<Lit>& i : S.base_learnts) {
+                vec<Lit> tmp;
+                i.copyTo(tmp);
+                S2.import_learnt(tmp);
+            }
+            extra.clear();
+            add_random_clauses(S2, extra, round);
+            check("taint import", S2, S2.solve(), none, extra);
+        }
+    }
+
+    //! assumption queries on several solvers of the instance, time-sliced by
+    //! a SolveScheduler with a small budget so that each takes many slices
+    void run_sched() {
+        constexpr int NR_SOLVER = 4;
+        std::vector<std::unique_ptr<Solver>> solvers;
+        for (int i = 0; i < NR_SOLVER; ++i) {
+            solvers.emplace_back(new Solver);
+            solvers.back()->verbosity = 0;
+            load(*solvers.back(), m_inst);
+        }
+        SolveScheduler sched{2, 100};
+        std::vector<vec<Lit>> assumps(NR_SOLVER);
+        for (int q = 0; q < 3; ++q) {
+            std::vector<SolveScheduler::Ticket> tickets;
+            for (int i = 0; i < NR_SOLVER; ++i) {
+                assumps[i].push(random_lit());
+                tickets.push_back(sched.submit(*solvers[i], assumps[i], i));
+            }
+            for (int i = 0; i < NR_SOLVER; ++i) {
+                lbool ret = tickets[i].result.get();
+                if (ret == l_Undef) {
+                    fprintf(stderr, "%s: sched: job %d not finished\n",
+                            m_inst.name.c_str(), i);
+                    ++m_nr_error;
+                    continue;
+                }
+                std::vector<vec<Lit>> units;
+                for (Lit p : assumps[i]) {
+                    units.emplace_back();
+                    units.back().push(p);
+                }
+                check("sched", *solvers[i], ret == l_True, assumps[i], units);
+            }
+        }
+    }
+
+    //! CEGAR-style refinement: on_model_candidate() adds clauses and LEQs
+    //! that the candidate falsifies, so the search backtracks from inside
+    //! the callback and goes on
+    void run_callback() {
+        CallbackSolver S;
+        S.verbosity = 0;
+        S.incremental = true;
+        load(S, m_inst);
+        std::vector<vec<Lit>> added;
+        std::vector<Leq> leqs;
+        int nr_refine = 0;
+        S.on_candidate = [&]() {
+            if (!nr_refine) {
+                return;
+            }
+            --nr_refine;
+            // true lits of distinct vars in the candidate
+            vec<Lit> lits;
+            for (int i = 0; i < 32 && lits.size() < 5; ++i) {
+                Var v = m_rng() % m_nr_var;
+                bool dup = false;
+                for (Lit p : lits) {
+                    dup |= var(p) == v;
+                }
+                if (!dup && S.value(v) != l_Undef) {
+                    lits.push(mkLit(v, S.value(v) == l_False));
+                }
+            }
+            int kind = m_rng() % 3, k = 1 + m_rng() % 3;
+            if (lits.size() <= k) {
+                return;
+            }
+            vec<Lit> ps;
+            if (kind == 0) {
+                // a clause of the negations
+                for (int i = 0; i < k; ++i) {
+                    ps.push(~lits[i]);
+                }
+                added.emplace_back();
+                ps.copyTo(added.back());
+                S.addClause_(ps);
+                return;
+            }
+            // true dst with more than bound true lits, or false dst with at
+            // most bound true lits
+            for (int i = 0; i < k; ++i) {
+                ps.push(lits[i]);
+            }
+            int bound = kind == 1 ? k - 1 : k;
+            Lit dst = kind == 1 ? lits[k] : ~lits[k];
+            leqs.emplace_back();
+            ps.copyTo(leqs.back().lits);
+            leqs.back().bound = bound;
+            leqs.back().dst = dst;
+            S.addLeqAssign_(ps, bound, dst);
+        };
+        vec<Lit> none;
+        for (int q = 0; q < 3; ++q) {
+            nr_refine = 4;
+            bool ret = S.solve();
+            check("callback", S, ret, none, added, leqs);
+            if (!ret) {
+                break;
+            }
+        }
+    }
+
+    //! SAT sweeping before a single solve(); the model must assign the
+    //! substituted vars consistently, also when a partial model is completed
+    void run_sweep() {
+        vec<Lit> none;
+        for (int partial = 0; partial < 2; ++partial) {
+            Solver S;
+            S.verbosity = 0;
+            S.partial_model = partial;
+            load(S, m_inst);
+            bool ret = S.sat_sweep() && S.solve();
+            if (ret && partial) {
+                S.complete_model();
+                for (int i = 0; i < m_nr_var; ++i) {
+                    if (S.modelValue(i) == l_Undef) {
+                        fprintf(stderr, "%s: sweep: var %d left undefined\n",
+                                m_inst.name.c_str(), i + 1);
+                        ++m_nr_error;
+                        return;
+                    }
+                }
+            }
+            check(partial ? "sweep-partial" : "sweep", S, ret, none, {});
+        }
+    }
+
+public:
+    Checker(const Instance& inst, unsigned seed) : m_rng{seed}, m_inst{inst} {}
+
+    //! return the number of mismatches
+    int run(const char* mode) {
+        Solver S;
+        S.verbosity = 0;
+        if (!strcmp(mode, "taint")) {
+            S.set_base_learnt_export(8, 30);
+        }
+        load(S, m_inst);
+        m_nr_var = S.nVars();
+        if (!m_nr_var) {
+            return 0;
+        }
+        if (!strcmp(mode, "assume")) {
+            run_assume(S);
+        } else if (!strcmp(mode, "add")) {
+            bool ret = S.solve();
+            if (ret != m_inst.sat) {
+                fprintf(stderr, "%s: expect %s, got %s\n", m_inst.name.c_str(),
+                        m_inst.sat ? "SAT" : "UNSAT", ret ? "SAT" : "UNSAT");
+                return 1;
+            }
+            run_add(S);
+        } else if (!strcmp(mode, "scope")) {
+            run_scope(S);
+        } else if (!strcmp(mode, "taint")) {
+            run_taint(S);
+        } else if (!strcmp(mode, "sched")) {
+            run_sched();
+        } else if (!strcmp(mode, "callback")) {
+            run_callback();
+        } else if (!strcmp(mode, "sweep")) {
+            run_sweep();
+        } else {
+            fprintf(stderr, "ERROR! Unknown mode: %s\n", mode);
+            exit(1);
+        }
+        return m_nr_error;
+    }
+};
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    setUsageHelp(
+            "USAGE: %s [options] <list-file> <input-dir>\n\n  Solve the "
+            "instances of the list with a sequence of queries and compare "
+            "the\n  answers with fresh solvers. Instances whose path starts "
+            "with SAT must be\n  satisfiable. Solver options apply to all "
+            "solvers.\n");
+
+    StringOption mode("MAIN", "mode",
+                      "Queries to check: assume (assumption sequences), add "
+                      "(clauses added between solves), scope (clauses in "
+                      "nested push/pop scopes), taint (learnts exported "
+                      "with non-base clauses), sched (assumption queries "
+                      "time-sliced by a SolveScheduler), callback "
+                      "(constraints added by on_model_candidate()) or sweep "
+                      "(a solve after sat_sweep()).",
+                      "assume");
+    StringOption filter("MAIN", "filter",
+                        "Only check instances whose path contains this.");
+
+    parseOptions(argc, argv, true);
+    if (argc != 3) {
+        printUsageAndExit(argc, argv);
+    }
+
+    std::ifstream list{argv[1]};
+    if (!list) {
+        fprintf(stderr, "ERROR! Could not open list: %s\n", argv[1]);
+        exit(1);
+    }
+    std::string name;
+    int nr_instance = 0, nr_error = 0;
+    while (std::getline(list, name)) {
+        if (name.empty() ||
+            (filter && name.find(filter) == std::string::npos)) {
+            continue;
+        }
+        Instance inst{name, read_file(std::string{argv[2]} + "/" + name),
+                      name.compare(0, 4, "SAT/") == 0};
+        nr_error += Checker{inst, unsigned(std::hash<std::string>{}(name))}
+                            .run(mode);
+        ++nr_instance;
+    }
+    printf("%d instances, %d errors\n", nr_instance, nr_error);
+    return nr_error ? 1 : 0;
+}
@@ -0,0 +1,308 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""tune solver options on a list of instances by successive halving
+
+Each round runs all surviving configurations on a prefix of the (shuffled)
+instance list, ranks them by PAR-k score and keeps the best 1/eta of them for
+the next round, which uses eta times as many instances. Runs are executed by
+a pool of solver processes and every finished run is stored in an SQLite
+database keyed by (solver, options, instance, budget); running the same
+command again resumes an interrupted session without repeating runs.
+"""
+
+import argparse
+import concurrent.futures
+import math
+import os
+import random
+import sqlite3
+import subprocess
+import sys
+import time
+
+
+class Param:
+    """a tunable solver option
+
+    :param field: the ``Solver`` member and ``Option`` names set by
+        ``Solver::apply_profile()``, or None for options that are not
+        profile parameters
+    """
+
+    def __init__(self, name, kind, default, *, lo=None, hi=None, log=False,
+                 choices=None, field=None):
+        self.name = name
+        self.kind = kind
+        self.default = default
+        self.lo = lo
+        self.hi = hi
+        self.log = log
+        self.choices = choices
+        self.field = field
+
+    def sample(self, rng):
+        if self.kind == 'bool':
+            return rng.random() < 0.5
+        if self.kind == 'choice':
+            return rng.choice(self.choices)
+        if self.log:
+            v = math.exp(rng.uniform(math.log(self.lo), math.log(self.hi)))
+        else:
+            v = rng.uniform(self.lo, self.hi)
+        if self.kind == 'int':
+            return int(round(v))
+        return float(f'{v:.4g}')
+
+    def arg(self, value):
+        if self.kind == 'bool':
+            return f'-{self.name}' if value else f'-no-{self.name}'
+        return f'-{self.name}={value}'
+
+
+CORE_PARAMS = [
+    Param('var-decay', 'float', 0.95, lo=0.75, hi=0.999,
+          field=('var_decay', 'opt_var_decay')),
+    Param('cla-decay', 'float', 0.999, lo=0.99, hi=0.9999,
+          field=('clause_decay', 'opt_clause_decay')),
+    Param('rinc', 'float', 2.0, lo=1.1, hi=4, log=True,
+          field=('restart_inc', 'opt_restart_inc')),
+    Param('rfirst', 'int', 100, lo=10, hi=1000, log=True,
+          field=('restart_first', 'opt_restart_first')),
+    Param('gc-frac', 'float', 0.2, lo=0.05, hi=0.5,
+          field=('garbage_frac', 'opt_garbage_frac')),
+    # ccmin-mode=1 is not implemented for LEQ reasons
+    Param('ccmin-mode', 'choice', 2, choices=[0, 2],
+          field=('ccmin_mode', 'opt_ccmin_mode')),
+    Param('phase-saving', 'choice', 2, choices=[0, 1, 2],
+          field=('phase_saving', 'opt_phase_saving')),
+    Param('luby', 'bool', True, field=('luby_restart', 'opt_luby_restart')),
+]
+
+SIMP_PARAMS = [
+    Param('grow', 'int', 0, lo=0, hi=16),
+    Param('cl-lim', 'choice', 20, choices=[-1, 10, 20, 40, 80]),
+    Param('sub-lim', 'int', 1000, lo=100, hi=10000, log=True),
+]
+
+
+class Config:
+    def __init__(self, params, values):
+        self.values = values
+        self.args = [p.arg(values[p.name]) for p in params]
+        self.key = ' '.join(self.args)
+
+
+class RunDB:
+    """persistent store of finished runs"""
+
+    def __init__(self, path):
+        self.conn = sqlite3.connect(path)
+        self.conn.execute(
+            'CREATE TABLE IF NOT EXISTS runs ('
+            'solver TEXT, options TEXT, instance TEXT, budget REAL, '
+            'status TEXT, time REAL, '
+            'PRIMARY KEY (solver, options, instance, budget))')
+        self.conn.commit()
+
+    def get(self, solver, options, instance, budget):
+        return self.conn.execute(
+            'SELECT status, time FROM runs WHERE solver=? AND options=? AND '
+            'instance=? AND budget=?',
+            (solver, options, instance, budget)).fetchone()
+
+    def put(self, solver, options, instance, budget, status, time_):
+        self.conn.execute('INSERT OR REPLACE INTO runs VALUES (?,?,?,?,?,?)',
+                          (solver, options, instance, budget, status, time_))
+        self.conn.commit()
+
+
+def run_solver(solver, args, instance, budget):
+    """run one instance; return (status, wall time)"""
+    start = time.monotonic()
+    try:
+        ret = subprocess.run([solver, '-verb=0'] + args + [instance],
+                             stdout=subprocess.DEVNULL,
+                             stderr=subprocess.DEVNULL,
+                             timeout=budget).returncode
+    except subprocess.TimeoutExpired:
+        return 'TIMEOUT', budget
+    elapsed = time.monotonic() - start
+    status = {10: 'SAT', 20: 'UNSAT', 0: 'INDET'}.get(ret, 'ERROR')
+    return status, elapsed
+
+
+class Tuner:
+    def __init__(self, args, params):
+        self.args = args
+        self.params = params
+        self.solver = os.path.abspath(args.solver)
+        self.db = RunDB(args.db)
+        self.pool = concurrent.futures.ThreadPoolExecutor(args.jobs)
+        self.nr_runs = 0
+        self.nr_cached = 0
+
+    def evaluate(self, configs, instances):
+        """make sure all runs exist; return {(config key, instance): result}"""
+        results = {}
+        futures = {}
+        for c in configs:
+            for inst in instances:
+                r = self.db.get(self.solver, c.key, inst, self.args.budget)
+                if r is not None:
+                    results[c.key, inst] = r
+                    self.nr_cached += 1
+                else:
+                    fut = self.pool.submit(run_solver, self.solver, c.args,
+                                           inst, self.args.budget)
+                    futures[fut] = (c.key, inst)
+        for fut in concurrent.futures.as_completed(futures):
+            key, inst = futures[fut]
+            status, elapsed = fut.result()
+            self.db.put(self.solver, key, inst, self.args.budget, status,
+                        elapsed)
+            results[key, inst] = (status, elapsed)
+            self.nr_runs += 1
+            if status == 'ERROR':
+                print(f'error: {inst} with {key}', file=sys.stderr)
+        return results
+
+    def score(self, config, instances, results):
+        """PAR-k score: mean time with unsolved runs counted as k * budget"""
+        tot = 0
+        for inst in instances:
+            status, elapsed = results[config.key, inst]
+            if status in ('SAT', 'UNSAT'):
+                tot += elapsed
+            else:
+                tot += self.args.penalty * self.args.budget
+        return tot / len(instances)
+
+    def check_consistency(self, configs, instances, results):
+        for inst in instances:
+            found = {results[c.key, inst][0] for c in configs} & {'SAT',
+                                                                  'UNSAT'}
+            if len(found) > 1:
+                print(f'WARNING: inconsistent results on {inst}',
+                      file=sys.stderr)
+
+    def run(self, instances):
+        rng = random.Random(self.args.seed)
+        configs = [Config(self.params,
+                          {p.name: p.default for p in self.params})]
+        seen = {configs[0].key}
+        while len(configs) < self.args.configs:
+            c = Config(self.params,
+                       {p.name: p.sample(rng) for p in self.params})
+            if c.key not in seen:
+                seen.add(c.key)
+                configs.append(c)
+
+        instances = list(instances)
+        rng.shuffle(instances)
+        nr_inst = min(self.args.min_instances, len(instances))
+        rnd = 0
+        while True:
+            subset = instances[:nr_inst]
+            results = self.evaluate(configs, subset)
+            self.check_consistency(configs, subset, results)
+            scores = {c.key: self.score(c, subset, results) for c in configs}
+            configs.sort(key=lambda c: scores[c.key])
+            print(f'round {rnd}: {len(configs)} configs on {nr_inst} '
+                  f'instances ({self.nr_runs} runs, {self.nr_cached} cached)')
+            for c in configs[:self.args.show]:
+                print(f'  {scores[c.key]:10.3f}  {c.key}')
+            sys.stdout.flush()
+            if nr_inst == len(instances) or len(configs) == 1:
+                return configs[0], scores[configs[0].key]
+            configs = configs[:max(1, len(configs) // self.args.eta)]
+            nr_inst = min(nr_inst * self.args.eta, len(instances))
+            if len(configs) == 1:
+                # report the score of the winner on all instances
+                nr_inst = len(instances)
+            rnd += 1
+
+
+def read_instances(path):
+    base = os.path.dirname(os.path.abspath(path))
+    ret = []
+    with open(path) as fin:
+        for line in fin:
+            line = line.strip()
+            if line and not line.startswith('#'):
+                ret.append(os.path.join(base, line))
+    return ret
+
+
+def format_profile(params, config):
+    """format as the body of a SolverProfile case in Solver::apply_profile()"""
+    lines = []
+    for p in params:
+        if p.field is None:
+            continue
+        field, opt = p.field
+        v = config.values[p.name]
+        if p.kind == 'bool':
+            v = 'true' if v else 'false'
+        lines.append(f'set({opt}, {field}, {v});')
+    return '\n'.join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='tune solver options by successive halving',
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter
+    )
+    parser.add_argument('solver', help='minisat or minisat-simp binary')
+    parser.add_argument('instances',
+                        help='file with one instance per line, relative to '
+                        'the file itself (such as tests/inputs/easy.txt)')
+    parser.add_argument('--db', default='tune.sqlite',
+                        help='database of finished runs')
+    parser.add_argument('--jobs', type=int, default=os.cpu_count(),
+                        help='number of concurrent solver processes')
+    parser.add_argument('--budget', type=float, default=60,
+                        help='wall clock limit per run in seconds')
+    parser.add_argument('--penalty', type=float, default=2,
+                        help='unsolved runs count as penalty * budget')
+    parser.add_argument('--configs', type=int, default=32,
+                        help='number of configurations in the first round, '
+                        'including the defaults')
+    parser.add_argument('--min-instances', type=int, default=4,
+                        help='number of instances in the first round')
+    parser.add_argument('--eta', type=int, default=2,
+                        help='keep 1/eta of the configurations per round')
+    parser.add_argument('--seed', type=int, default=0,
+                        help='seed for sampling configurations and ordering '
+                        'instances; keep it when resuming')
+    parser.add_argument('--simp', action='store_true',
+                        help='also tune the SimpSolver options (needs '
+                        'minisat-simp)')
+    parser.add_argument('--show', type=int, default=5,
+                        help='number of configurations to print per round')
+    parser.add_argument('--output',
+                        help='write the best options string to this file')
+    parser.add_argument('--profile', action='store_true',
+                        help='also print the best configuration as a '
+                        'Solver::apply_profile() case')
+    args = parser.parse_args()
+
+    assert args.eta >= 2 and args.configs >= 1 and args.min_instances >= 1
+    params = CORE_PARAMS + (SIMP_PARAMS if args.simp else [])
+    instances = read_instances(args.instances)
+    if not instances:
+        parser.error(f'no instances in {args.instances}')
+
+    tuner = Tuner(args, params)
+    best, score = tuner.run(instances)
+    print(f'best (PAR-{args.penalty:g} {score:.3f}): {best.key}')
+    if args.output:
+        with open(args.output, 'w') as fout:
+            fout.write(best.key)
+            fout.write('\n')
+    if args.profile:
+        print(format_profile(params, best))
+
+
+if __name__ == '__main__':
+    main()